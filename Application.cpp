@@ -21,6 +21,11 @@ namespace ClassGame {
     static bool LogWin = true;
     static bool GameWin = true;      // Game window
     static bool ControlWin = true;   // Game control panel
+    static bool SearchWin = true;    // AI search statistics
+
+    // searches already logged, and where the logger writes each one as a line of JSON
+    static unsigned int loggedSearchCount = 0;
+    static const char *SEARCH_STATS_FILE = "search_stats.jsonl";
 
     // Default hex color (clear)
     static float colorR = 115.0f / 255.0f;
@@ -47,13 +52,14 @@ namespace ClassGame {
     void GameStartUp() 
     {
         // Initialize Logger
-        Logger::GetInstance().Init();
+        Logger::GetInstance().Init("game_log.txt", SEARCH_STATS_FILE);
         
         // Allow user to choose game mode and start a new game
         game = nullptr;
         gameOver = false;
         gameWinner = -1;
         gameActCounter = 0;
+        loggedSearchCount = 0;
         selectedGameMode = MODE_HUMAN_VS_HUMAN;
         aiPlayerNumber = 2;
         aiAsPlayer1 = false;
@@ -61,17 +67,31 @@ namespace ClassGame {
         LOG_INFO("Game application started. Select a game to begin.");
     }
 
+    //
+    // called by main.cpp once the render loop is done, while the graphics device
+    // is still there to free the cached textures
+    //
+    void GameShutDown()
+    {
+        delete game;
+        game = nullptr;
+        Sprite::purgeTextureCache();
+    }
+
     //
     // Helper function to reset the current game
     //
     void ResetCurrentGame() 
     {
         if (game) {
+            game->cancelAI();
             game->stopGame();
             game->setUpBoard();
             gameOver = false;
             gameWinner = -1;
             gameActCounter = 0;
+            // the game keeps counting its searches, the last one is already logged
+            loggedSearchCount = game->searchCount();
             
             // Reconfigure AI settings
             if (game) {
@@ -94,12 +114,16 @@ namespace ClassGame {
     //
     void StartGameWithMode(Game* newGame, const std::string& gameName) 
     {
+        if (game) {
+            game->cancelAI();
+        }
         delete game;
         game = newGame;
         game->setUpBoard();
         gameOver = false;
         gameWinner = -1;
         gameActCounter = 0;
+        loggedSearchCount = 0;
         
         // Configure AI settings based on selected mode
         if (selectedGameMode == MODE_AI_VS_AI) {
@@ -226,9 +250,20 @@ namespace ClassGame {
             ImGui::Text("Mode: %s", modeStr.c_str());
             
             // Player information
-            if (dynamic_cast<Connect4*>(game)) {
+            if (Connect4* connect4 = dynamic_cast<Connect4*>(game)) {
                 ImGui::Text("Player 1: Red");
                 ImGui::Text("Player 2: Yellow");
+
+                bool solverMode = connect4->getSolverMode();
+                if (ImGui::Checkbox("AI plays perfectly when it can solve", &solverMode)) {
+                    connect4->setSolverMode(solverMode);
+                    LOG_INFO_TAG(std::string("Connect 4 solver ") + (solverMode ? "on" : "off"), "SETTINGS");
+                }
+                Connect4Solver::Outcome outcome = connect4->getSolvedOutcome();
+                if (outcome != Connect4Solver::OUTCOME_UNKNOWN) {
+                    static const char *OUTCOME_NAMES[3] = {"a loss", "a draw", "a win"};
+                    ImGui::Text("Last AI move: solved, %s with best play", OUTCOME_NAMES[outcome + 1]);
+                }
             } else if (dynamic_cast<TicTacToe*>(game)) {
                 ImGui::Text("Player 1: X");
                 ImGui::Text("Player 2: O");
@@ -245,7 +280,7 @@ namespace ClassGame {
             }
             
             // Display board state string
-            std::string state = game->stateString();
+            const std::string &state = game->stateString();
             ImGui::Text("Board State:");
             ImGui::SameLine();
             if (ImGui::SmallButton("Copy##State")) {
@@ -269,11 +304,13 @@ namespace ClassGame {
             ImGui::SameLine();
             
             if (ImGui::Button("Change Game")) {
+                game->cancelAI();
                 delete game;
                 game = nullptr;
                 gameOver = false;
                 gameWinner = -1;
                 gameActCounter = 0;
+                loggedSearchCount = 0;
                 LOG_INFO_TAG("Game cleared - select a new game", "GAME");
             }
             
@@ -309,6 +346,9 @@ namespace ClassGame {
                 game->getCurrentPlayer() && game->getCurrentPlayer()->isAIPlayer()) {
                 ImGui::Separator();
                 ImGui::Text("AI Analysis:");
+                if (game->isAIThinking()) {
+                    ImGui::Text("Thinking...");
+                }
                 ImGui::Text("Best Move Column: %d", connect4Game->getBestMoveColumn());
             }
         } else {
@@ -317,6 +357,31 @@ namespace ClassGame {
         }
         ImGui::End();
 
+        // Search statistics of the AI's last move
+        if (SearchWin) {
+            ImGui::Begin("AI Search", &SearchWin);
+            if (game && game->isAIThinking()) {
+                ImGui::TextColored(ImVec4(1, 0.5f, 0, 1), "Thinking...");
+            }
+            if (game && game->searchCount() > 0) {
+                const SearchStats &stats = game->lastSearchStats();
+                ImGui::Text("Move %u, from the %s", game->searchCount(), stats.source.c_str());
+                ImGui::Separator();
+                ImGui::Text("Depth:    %d", stats.completedDepth);
+                ImGui::Text("Score:    %d", stats.score);
+                ImGui::Text("Nodes:    %llu", (unsigned long long)stats.nodes);
+                ImGui::Text("Time:     %.1f ms", stats.seconds * 1000.0);
+                ImGui::Text("Speed:    %.0f nodes/s", stats.nodesPerSecond());
+                ImGui::Text("Cutoffs:  %llu", (unsigned long long)stats.cutoffs);
+                ImGui::Text("TT hits:  %llu of %llu (%.1f%%)", (unsigned long long)stats.ttHits,
+                            (unsigned long long)stats.ttProbes, stats.ttHitRate() * 100.0);
+                ImGui::TextWrapped("PV:       %s", stats.pvString().c_str());
+            } else {
+                ImGui::Text("No AI move searched yet.");
+            }
+            ImGui::End();
+        }
+
         // Game Log Window
         if (LogWin) {
             ImGui::Begin("Game Log", &LogWin);
@@ -372,37 +437,34 @@ namespace ClassGame {
             ImGui::Separator();
 
             // Display log entries with filtering
-            const auto& entries = Logger::GetInstance().GetEntries();
-            const auto& colors = Logger::GetInstance().GetColors();
-            
             const float footer_height = ImGui::GetStyle().ItemSpacing.y + ImGui::GetFrameHeightWithSpacing();
             ImGui::BeginChild("LogScrollRegion", ImVec2(0, -footer_height), true);
             
-            for (size_t i = 0; i < entries.size(); i++) {
+            Logger::GetInstance().ForEachEntry([&](const std::string& entry, const ImVec4& color) {
                 bool display = true;
                 
-                if (entries[i].find("[INFO]") != std::string::npos && !showInfo) { 
+                if (entry.find("[INFO]") != std::string::npos && !showInfo) { 
                     display = false; 
                 }
-                else if (entries[i].find("[WARN]") != std::string::npos && !showWarning) { 
+                else if (entry.find("[WARN]") != std::string::npos && !showWarning) { 
                     display = false; 
                 }
-                else if (entries[i].find("[ERROR]") != std::string::npos && !showError) { 
+                else if (entry.find("[ERROR]") != std::string::npos && !showError) { 
                     display = false; 
                 }
-                else if (entries[i].find("[AI SCORE]") != std::string::npos && !showScores) { 
+                else if (entry.find("[AI SCORE]") != std::string::npos && !showScores) { 
                     display = false; 
                 }
-                else if (entries[i].find("[DEBUG]") != std::string::npos && !showDebug) { 
+                else if (entry.find("[DEBUG]") != std::string::npos && !showDebug) { 
                     display = false; 
                 }
                 
                 if (display) {
-                    ImGui::PushStyleColor(ImGuiCol_Text, colors[i]);
-                    ImGui::Text("%s", entries[i].c_str());
+                    ImGui::PushStyleColor(ImGuiCol_Text, color);
+                    ImGui::Text("%s", entry.c_str());
                     ImGui::PopStyleColor();
                 }
-            }
+            });
             
             if (ImGui::GetScrollY() >= ImGui::GetScrollMaxY()) {
                 ImGui::SetScrollHereY(1.0f);
@@ -456,6 +518,10 @@ namespace ClassGame {
             ImGui::SameLine();
             ImGui::Text("Game Window");
 
+            ImGui::Checkbox("##SearchCheck", &SearchWin);
+            ImGui::SameLine();
+            ImGui::Text("AI Search Window");
+
             ImGui::Separator();
 
             // Game control buttons
@@ -470,11 +536,15 @@ namespace ClassGame {
             ImGui::SameLine();
             
             if (ImGui::Button("New Game")) {
+                if (game) {
+                    game->cancelAI();
+                }
                 delete game;
                 game = nullptr;
                 gameOver = false;
                 gameWinner = -1;
                 gameActCounter = 0;
+                loggedSearchCount = 0;
                 LOG_INFO_TAG("Game cleared - ready for new game selection", "GAME");
             }
 
@@ -572,7 +642,15 @@ namespace ClassGame {
         
         // Increment action counter
         gameActCounter++;
-        
+
+        // The AI's search, to the log and the stats file, before the game can end
+        if (game->searchCount() != loggedSearchCount) {
+            loggedSearchCount = game->searchCount();
+            const SearchStats &stats = game->lastSearchStats();
+            LOG_INFO_TAG(stats.toString(), "SEARCH");
+            Logger::GetInstance().Record("{\"turn\": " + std::to_string(gameActCounter) + ", \"search\": " + stats.toJson() + "}");
+        }
+
         // Check for winner or draw
         Player *winner = game->checkForWinner();
         if (winner) {
@@ -595,7 +673,7 @@ namespace ClassGame {
         // Log the state string after the move (only if game didn't end)
         // Note: getCurrentPlayer() has already switched, so we need the previous player
         int previousPlayerNum = (game->getCurrentPlayer()->playerNumber() + 1) % 2 + 1;
-        std::string state = game->stateString();
+        const std::string &state = game->stateString();
         
         // Log AI move information if it was AI's turn
         bool wasAITurn = game->getPlayerAt(previousPlayerNum - 1)->isAIPlayer();
@@ -1,80 +1,176 @@
 #include "Logger.h"
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
+#include <ctime>
 
 namespace ClassGame {
 
+// how long the writer sleeps when there is nothing queued, producers never wake it
+static const int WRITER_POLL_MS = 10;
+
+Logger::Logger()
+    : head(nullptr), tail(nullptr), ring(MAX_ENTRIES), ringStart(0), ringCount(0),
+      stopping(false), initialized(false) {
+    // the queue starts with an empty node already read
+    Node* stub = new Node();
+    stub->next.store(nullptr, std::memory_order_relaxed);
+    head.store(stub, std::memory_order_relaxed);
+    tail = stub;
+}
+
+Logger::~Logger() {
+    stopping = true;
+    wake.notify_one();
+    if (writer.joinable()) {
+        writer.join();
+    }
+    Entry entry;
+    while (Pop(entry)) {}
+    delete tail;
+    logFile.close();
+    recordFile.close();
+}
+
 // Logger initialization and system feedback
-void Logger::Init(const std::string& filename) {
+void Logger::Init(const std::string& filename, const std::string& recordFilename) {
     if (initialized) return;
-    
+
     logFile.open(filename, std::ios::app);
-    if (logFile.is_open()) {
-        auto now = std::chrono::system_clock::now();
-        auto time_t = std::chrono::system_clock::to_time_t(now);
-        
-        char timeStr[26];
-        ctime_s(timeStr, sizeof(timeStr), &time_t);
+    if (!recordFilename.empty()) {
+        recordFile.open(recordFilename, std::ios::app);
     }
-    
+    writer = std::thread(&Logger::WriterLoop, this);
+
     initialized = true;
     Info("Game started successfully");
     Info("Application initialized", "GAME");
 }
 
+void Logger::Push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+// the node read from becomes the new tail, and the old one is freed
+bool Logger::Pop(Entry& entry) {
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (!next) return false;
+
+    entry = std::move(next->entry);
+    delete tail;
+    tail = next;
+    return true;
+}
+
+bool Logger::Drain(std::string& batch, std::string& records) {
+    std::vector<Entry> drained;
+    Entry entry;
+    bool any = false;
+    while (Pop(entry)) {
+        any = true;
+        if (entry.record) {
+            records += entry.text;
+            records += '\n';
+        } else {
+            drained.push_back(std::move(entry));
+        }
+    }
+    if (drained.empty()) return any;
+
+    for (const Entry& line : drained) {
+        batch += line.text;
+        batch += '\n';
+    }
+    std::lock_guard<std::mutex> lock(viewMutex);
+    for (Entry& line : drained) {
+        ring[ringStart] = std::move(line);
+        ringStart = (ringStart + 1) % MAX_ENTRIES;
+        if (ringCount < MAX_ENTRIES) ringCount++;
+    }
+    return true;
+}
+
+void Logger::WriterLoop() {
+    std::string batch;
+    std::string records;
+    auto lastFlush = std::chrono::steady_clock::now();
+    bool unflushed = false;
+
+    while (true) {
+        bool done = stopping;
+        if (Drain(batch, records)) {
+            if (logFile.is_open() && !batch.empty()) {
+                logFile.write(batch.data(), (std::streamsize)batch.size());
+                unflushed = true;
+            }
+            if (recordFile.is_open() && !records.empty()) {
+                recordFile.write(records.data(), (std::streamsize)records.size());
+                unflushed = true;
+            }
+        }
+        batch.clear();
+        records.clear();
+
+        auto now = std::chrono::steady_clock::now();
+        if (unflushed && (done || now - lastFlush >= std::chrono::milliseconds(FLUSH_INTERVAL_MS))) {
+            logFile.flush();
+            recordFile.flush();
+            unflushed = false;
+            lastFlush = now;
+        }
+        if (done) break;
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        wake.wait_for(lock, std::chrono::milliseconds(WRITER_POLL_MS), [this] { return stopping.load(); });
+    }
+}
+
 // Define entry pattern - timestamp, tag, and message
 // Outputs to Game Log Window, console, and game_log.txt (in Debug folder or local)
 void Logger::AddEntry(const std::string& level, const std::string& message, const std::string& tag, const ImVec4& color) {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+    int ms = (int)(std::chrono::duration_cast<std::chrono::milliseconds>(
         now.time_since_epoch()
-    ) % 1000;
-    
-    std::stringstream ss;
-    
-    std::tm tm;
-    localtime_s(&tm, &time_t);
-    
-    // Format: [HH:MM:SS.mmm]
-    ss << "["
-       << std::setfill('0') 
-       << std::setw(2) << tm.tm_hour << ":"
-       << std::setw(2) << tm.tm_min << ":"
-       << std::setw(2) << tm.tm_sec
-       << "." << std::setw(3) << ms.count()
-       << "] ";
-    
-    // Add level: [INFO], [WARN], [ERROR]
-    ss << "[" << level << "] ";
-    
-    // Add tag ([GAME])
-    if (!tag.empty()) {
-        ss << "[" << tag << "] ";
-    }
-    
-    // Add the actual message
-    ss << message;
-    
-    std::string entry = ss.str();
-    entries.push_back(entry);
-    colors.push_back(color);
-    
-    if (entries.size() > 1000) {
-        entries.erase(entries.begin());
-        colors.erase(colors.begin());
+    ).count() % 1000);
+
+    // the local time only changes once a second, so each thread keeps the last one
+    thread_local std::time_t cachedSecond = -1;
+    thread_local std::tm tm;
+    if (time_t != cachedSecond) {
+#ifdef _WIN32
+        localtime_s(&tm, &time_t);
+#else
+        localtime_r(&time_t, &tm);
+#endif
+        cachedSecond = time_t;
     }
-    
-    // Write to file
-    if (logFile.is_open()) {
-        logFile << entry << "\n";
-        logFile.flush();
+
+    // Format: [HH:MM:SS.mmm] [LEVEL] [TAG] message
+    char stamp[32];
+    snprintf(stamp, sizeof(stamp), "[%02d:%02d:%02d.%03d] ", tm.tm_hour, tm.tm_min, tm.tm_sec, ms);
+
+    Node* node = new Node();
+    std::string& entry = node->entry.text;
+    entry.reserve(32 + level.size() + tag.size() + message.size());
+    entry += stamp;
+    entry += "[";
+    entry += level;
+    entry += "] ";
+    if (!tag.empty()) {
+        entry += "[";
+        entry += tag;
+        entry += "] ";
     }
-    
+    entry += message;
+    node->entry.color = color;
+
     // Also print to console
     #ifdef _DEBUG
     printf("%s\n", entry.c_str());
     #endif
+
+    Push(node);
 }
 
 void Logger::Info(const std::string& message, const std::string& tag) {
@@ -94,9 +190,21 @@ void Logger::GameEvent(const std::string& message) {
     AddEntry("INFO", message, "GAME", ImVec4(1.0f, 1.0f, 1.0f, 1.0f)); // White with [GAME] tag
 }
 
+void Logger::Record(const std::string& line) {
+    Node* node = new Node();
+    node->entry.text = line;
+    node->entry.record = true;
+    Push(node);
+}
+
+// lines still queued show up after the clear
 void Logger::Clear() {
-    entries.clear();
-    colors.clear();
+    std::lock_guard<std::mutex> lock(viewMutex);
+    for (Entry& entry : ring) {
+        entry.text.clear();
+    }
+    ringStart = 0;
+    ringCount = 0;
 }
 
-}
\ No newline at end of file
+}
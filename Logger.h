@@ -4,40 +4,102 @@
 #include <vector>
 #include <fstream>
 #include <chrono>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include "imgui/imgui.h"
 
 namespace ClassGame {
 
+//
+// logging never waits on the disk: callers format the line and push it onto a lock free
+// queue, and a background thread moves lines from there into the window's ring and,
+// in batches, into the log file, flushing it every FLUSH_INTERVAL_MS
+// records, lines of data such as JSON, take the same queue to a file of their own and
+// stay out of the window; both files are flushed and closed when the logger goes away
+//
 class Logger {
 public:
     static Logger& GetInstance() {
         static Logger instance;
         return instance;
     }
-    
-    // Initialize
-    void Init(const std::string& filename = "game_log.txt");
-    
-    // Logging functions
+
+    // lines the log window keeps, the oldest are overwritten
+    static constexpr size_t MAX_ENTRIES = 1024;
+    static constexpr int FLUSH_INTERVAL_MS = 250;
+
+    // Initialize, records are only kept if a record file is given
+    void Init(const std::string& filename = "game_log.txt", const std::string& recordFilename = "");
+
+    // Logging functions, safe from any thread
     void Info(const std::string& message, const std::string& tag = "");
     void Warning(const std::string& message, const std::string& tag = "");
     void Error(const std::string& message, const std::string& tag = "");
     void GameEvent(const std::string& message);
-    
-    // UI display
-    const std::vector<std::string>& GetEntries() const { return entries; }
-    const std::vector<ImVec4>& GetColors() const { return colors; }
+    // one line for the record file as it is, no timestamp, safe from any thread
+    void Record(const std::string& line);
+
+    // UI display, f(entry, color) for each line in the window, oldest first
+    template <typename F>
+    void ForEachEntry(F f) {
+        std::lock_guard<std::mutex> lock(viewMutex);
+        size_t first = (ringStart + MAX_ENTRIES - ringCount) % MAX_ENTRIES;
+        for (size_t i = 0; i < ringCount; i++) {
+            const Entry& entry = ring[(first + i) % MAX_ENTRIES];
+            f(entry.text, entry.color);
+        }
+    }
     void Clear();
-    
+
 private:
-    Logger() = default;
-    void AddEntry(const std::string& level, const std::string& message, 
+    struct Entry {
+        std::string text;
+        ImVec4 color;
+        // for the record file rather than the log
+        bool record = false;
+    };
+
+    // node of the producer queue, the consumer always keeps one it has already read
+    struct Node {
+        std::atomic<Node*> next;
+        Entry entry;
+    };
+
+    Logger();
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    void AddEntry(const std::string& level, const std::string& message,
                  const std::string& tag, const ImVec4& color);
-    
-    std::vector<std::string> entries;
-    std::vector<ImVec4> colors;
+    // queue, producers side
+    void Push(Node* node);
+    // queue, writer side, false when it is empty
+    bool Pop(Entry& entry);
+    // writer thread
+    void WriterLoop();
+    // move everything queued into the ring and the two batches, true if there was anything
+    bool Drain(std::string& batch, std::string& records);
+
+    // producers swap themselves in at head, the writer reads from tail
+    std::atomic<Node*> head;
+    Node* tail;
+
+    // the window's view, written by the writer thread
+    std::vector<Entry> ring;
+    size_t ringStart;
+    size_t ringCount;
+    std::mutex viewMutex;
+
     std::ofstream logFile;
-    bool initialized = false;
+    std::ofstream recordFile;
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping;
+    bool initialized;
 };
 
 // Macros
@@ -7,6 +7,18 @@ Bit::~Bit()
 {
 }
 
+void Bit::destroy()
+{
+	if (_pool)
+	{
+		_pool->destroy(this);
+	}
+	else
+	{
+		delete this;
+	}
+}
+
 BitHolder *Bit::getHolder()
 {
 	// Look for my nearest ancestor that's a BitHolder:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Sprite.h"
+#include "ObjectPool.h"
 
 class Player;
 class BitHolder;
@@ -29,9 +30,14 @@ public:
 		_gameTag = 0;
 		_entityType = EntityBit;
 		_moving = false;
+		_pool = nullptr;
 	};
 
-	~Bit();
+	~Bit() override;
+
+	// bits a game makes come from its pool and go back there, anything else is deleted
+	void setPool(ObjectPool<Bit> *pool) { _pool = pool; };
+	void destroy() override;
 
 	// helper functions
 	bool getPickedUp();
@@ -63,4 +69,5 @@ private:
 	ImVec2 _destinationPosition;
 	ImVec2 _destinationStep;
 	bool _moving;
+	ObjectPool<Bit> *_pool;
 };
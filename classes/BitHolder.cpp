@@ -28,7 +28,7 @@ void BitHolder::setBit(Bit *abit)
 	{
 		if (_bit)
 		{
-			delete _bit;
+			_bit->destroy();
 			_bit = nullptr;
 		}
 		_bit = abit;
@@ -43,11 +43,16 @@ void BitHolder::destroyBit()
 {
 	if (_bit)
 	{
-		delete _bit;
+		_bit->destroy();
 		_bit = nullptr;
 	}
 }
 
+void BitHolder::forgetBit()
+{
+	_bit = nullptr;
+}
+
 Bit *BitHolder::canDragBit(Bit *bit)
 {
 	if (bit->getParent() == this && bit->friendly())
@@ -1,14 +1,16 @@
 #include "Checkers.h"
+#include <cstdlib>
 
 Checkers::Checkers() : Game() {
     _grid = new Grid(8, 8);
-    _mustContinueJumping = false;
-    _jumpingPiece = nullptr;
-    _redPieces = 12;
-    _yellowPieces = 12;
+    _searchMaxDepth = 0;
+    _searchTimeBudgetMs = 0;
+    resetHops();
 }
 
 Checkers::~Checkers() {
+    // the worker may still be searching with our AI
+    cancelAI();
     delete _grid;
 }
 
@@ -20,100 +22,126 @@ void Checkers::setUpBoard() {
     // Initialize all squares
     _grid->initializeSquares(80, "boardsquare.png");
 
-    // Enable only dark squares and place pieces
+    // Enable only dark squares
     _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        bool isDark = (x + y) % 2 == 1;
-        _grid->setEnabled(x, y, isDark);
-
-        if (isDark) {
-            if (y < 3) {
-                Bit* piece = createPiece(RED_PIECE);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            } else if (y > 4) {
-                Bit* piece = createPiece(YELLOW_PIECE);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            }
-        }
+        _grid->setEnabled(x, y, (x + y) % 2 == 1);
     });
 
+    // Place pieces
+    _board.reset();
+    resetHops();
+    syncGrid();
+
+    if (gameHasAI()) {
+        setAIPlayer(AI_PLAYER);
+    }
+
     startGame();
 }
 
 Bit* Checkers::createPiece(int pieceType) {
-    Bit* bit = new Bit();
-    bool isRed = (pieceType == RED_PIECE || pieceType == RED_KING);
+    Bit* bit = newBit();
+    bool isRed = (pieceType == CheckersBoard::RED_PIECE || pieceType == CheckersBoard::RED_KING);
     bit->LoadTextureFromFile(isRed ? "red.png" : "yellow.png");
     bit->setOwner(getPlayerAt(isRed ? RED_PLAYER : YELLOW_PLAYER));
-    bit->setGameTag(pieceType);
-    if (pieceType == RED_KING || pieceType == YELLOW_KING)
-        bit->setScale(1.3f);
+    setPieceType(bit, pieceType);
     return bit;
 }
 
-bool Checkers::actionForEmptyHolder(BitHolder &holder) {
-    return false; // Checkers doesn't place new pieces
+void Checkers::setPieceType(Bit* bit, int pieceType) {
+    bit->setGameTag(pieceType);
+    if (pieceType == CheckersBoard::RED_KING || pieceType == CheckersBoard::YELLOW_KING)
+        bit->setScale(1.3f);
 }
 
-bool Checkers::canBitMoveFrom(Bit &bit, BitHolder &src) {
-    if (!src.bit() || bit.getOwner() != getCurrentPlayer()) return false;
-    if (_mustContinueJumping && &src != _jumpingPiece) return false;
+//
+// mirror _board into the grid, only touching squares whose piece changed
+// a man that was crowned keeps its Bit and just grows
+//
+void Checkers::syncGrid() {
+    for (int index = 0; index < CheckersBoard::NUM_SQUARES; index++) {
+        int x, y;
+        CheckersBoard::coordinatesOf(index, x, y);
+        ChessSquare* square = _grid->getSquare(x, y);
+
+        int want = _board.pieceAt(index);
+        Bit* bit = square->bit();
+        int have = bit ? bit->gameTag() : CheckersBoard::EMPTY;
+        if (have == want) continue;
+        invalidateStateString();
+
+        if (want == CheckersBoard::EMPTY) {
+            square->destroyBit();
+        } else if (bit && (have + 1) / 2 == (want + 1) / 2) {
+            // RED_PIECE/RED_KING and YELLOW_PIECE/YELLOW_KING pair up here
+            setPieceType(bit, want);
+        } else {
+            Bit* piece = createPiece(want);
+            piece->setPosition(square->getPosition());
+            square->setBit(piece);
+        }
+    }
+}
 
-    ChessSquare* square = static_cast<ChessSquare*>(&src);
-    int x = square->getColumn();
-    int y = square->getRow();
+int Checkers::squareOf(BitHolder &holder) const {
+    ChessSquare* square = static_cast<ChessSquare*>(&holder);
+    return CheckersBoard::squareAt(square->getColumn(), square->getRow());
+}
 
-    // Must jump if available
-    if (hasJumpAvailable(bit.getOwner())) {
-        return canJumpFrom(*square);
+// is this legal move the one the human has been hopping along so far?
+bool Checkers::matchesHops(const CheckersMove &move) const {
+    if (move.from != _hopOrigin || move.numJumps < _numHops) return false;
+    for (int i = 0; i < _numHops; i++) {
+        if (move.path[i] != _hops[i]) return false;
     }
     return true;
 }
 
-bool Checkers::canBitMoveFromTo(Bit& bit, BitHolder& src, BitHolder& dst) {
-    if (!src.bit() || dst.bit()) return false;
+void Checkers::resetHops() {
+    _numHops = 0;
+    _hopOrigin = -1;
+}
 
-    ChessSquare* srcSquare = static_cast<ChessSquare*>(&src);
-    ChessSquare* dstSquare = static_cast<ChessSquare*>(&dst);
+bool Checkers::actionForEmptyHolder(BitHolder &holder) {
+    return false; // Checkers doesn't place new pieces
+}
 
-    int srcX = srcSquare->getColumn();
-    int srcY = srcSquare->getRow();
+bool Checkers::canBitMoveFrom(Bit &bit, BitHolder &src) {
+    if (!src.bit() || bit.getOwner() != getCurrentPlayer()) return false;
 
-    if (!_grid->isEnabled(dstSquare->getColumn(), dstSquare->getRow())) return false;
+    int from = squareOf(src);
+    if (from < 0) return false;
 
-    bool isKing = (bit.gameTag() == RED_KING || bit.gameTag() == YELLOW_KING);
-    bool isRed = (bit.getOwner() == getPlayerAt(RED_PLAYER));
+    // part way through a jump chain only the jumping piece can move
+    if (_numHops > 0) return from == _hops[_numHops - 1];
 
-    // Simple moves (if no jumps required)
-    if (!_mustContinueJumping && !hasJumpAvailable(bit.getOwner())) {
-        if (isKing) {
-            return dstSquare == _grid->getFL(srcX, srcY) || dstSquare == _grid->getFR(srcX, srcY) ||
-                   dstSquare == _grid->getBL(srcX, srcY) || dstSquare == _grid->getBR(srcX, srcY);
-        }
-        return isRed ? (dstSquare == _grid->getBL(srcX, srcY) || dstSquare == _grid->getBR(srcX, srcY)) :
-                       (dstSquare == _grid->getFL(srcX, srcY) || dstSquare == _grid->getFR(srcX, srcY));
+    // captures are mandatory, the core only offers jumps when there are any
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+    int count = _board.generateMoves(moves);
+    for (int i = 0; i < count; i++) {
+        if (moves[i].from == from) return true;
     }
+    return false;
+}
 
-    // Jump moves
-    if (_mustContinueJumping && &src != _jumpingPiece) return false;
-
-    // Check all jump directions
-    auto checkJump = [&](ChessSquare* middle, ChessSquare* target) -> bool {
-        if (!middle || !target || !middle->bit()) return false;
-        if (middle->bit()->getOwner() == bit.getOwner()) return false;
-        return dstSquare == target;
-    };
+bool Checkers::canBitMoveFromTo(Bit& bit, BitHolder& src, BitHolder& dst) {
+    if (!src.bit() || dst.bit()) return false;
 
-    if (isKing || !isRed) {
-        if (checkJump(_grid->getFL(srcX, srcY), _grid->getFLFL(srcX, srcY))) return true;
-        if (checkJump(_grid->getFR(srcX, srcY), _grid->getFRFR(srcX, srcY))) return true;
-    }
-    if (isKing || isRed) {
-        if (checkJump(_grid->getBL(srcX, srcY), _grid->getBLBL(srcX, srcY))) return true;
-        if (checkJump(_grid->getBR(srcX, srcY), _grid->getBRBR(srcX, srcY))) return true;
+    int from = squareOf(src);
+    int to = squareOf(dst);
+    if (from < 0 || to < 0) return false;
+
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+    int count = _board.generateMoves(moves);
+    for (int i = 0; i < count; i++) {
+        const CheckersMove &move = moves[i];
+        if (_numHops == 0) {
+            if (move.from != from) continue;
+            if (move.numJumps == 0 ? move.to == to : move.path[0] == to) return true;
+        } else if (matchesHops(move) && move.numJumps > _numHops && move.path[_numHops] == to) {
+            return true;
+        }
     }
-
     return false;
 }
 
@@ -125,124 +153,46 @@ void Checkers::bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     int srcY = srcSquare->getRow();
     int dstX = dstSquare->getColumn();
     int dstY = dstSquare->getRow();
-
-    // Check for jump
-    ChessSquare* jumped = nullptr;
-    if (dstSquare == _grid->getFLFL(srcX, srcY)) jumped = _grid->getFL(srcX, srcY);
-    else if (dstSquare == _grid->getFRFR(srcX, srcY)) jumped = _grid->getFR(srcX, srcY);
-    else if (dstSquare == _grid->getBLBL(srcX, srcY)) jumped = _grid->getBL(srcX, srcY);
-    else if (dstSquare == _grid->getBRBR(srcX, srcY)) jumped = _grid->getBR(srcX, srcY);
-
-    if (jumped && jumped->bit()) {
-        // Capture
-        (jumped->bit()->getOwner() == getPlayerAt(RED_PLAYER)) ? _redPieces-- : _yellowPieces--;
-        jumped->destroyBit();
-
-        // Promotion check
-        if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
-            bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
-            bit.setScale(1.3f);
-        }
-
-        // Check for more jumps
-        if (canJumpFrom(*dstSquare)) {
-            _mustContinueJumping = true;
-            _jumpingPiece = &dst;
-            return;
+    int from = squareOf(src);
+    int to = squareOf(dst);
+
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+    int count = _board.generateMoves(moves);
+
+    if (abs(dstX - srcX) == 2) {
+        // one hop of a jump chain, take the jumped piece off the view straight away
+        _grid->getSquare((srcX + dstX) / 2, (srcY + dstY) / 2)->destroyBit();
+        if (_numHops == 0) _hopOrigin = from;
+        _hops[_numHops++] = (uint8_t)to;
+
+        for (int i = 0; i < count; i++) {
+            if (matchesHops(moves[i]) && moves[i].numJumps == _numHops) {
+                _board.makeMove(moves[i]);
+                recordMove(i);
+                break;
+            }
         }
+        // more jumps to come, the same piece keeps moving
+        if (_board.currentPlayer() == getCurrentPlayer()->playerNumber()) return;
     } else {
-        // Regular move - promotion check
-        if ((bit.gameTag() == RED_PIECE && dstY == 7) || (bit.gameTag() == YELLOW_PIECE && dstY == 0)) {
-            bit.setGameTag(bit.gameTag() == RED_PIECE ? RED_KING : YELLOW_KING);
-            bit.setScale(1.3f);
+        for (int i = 0; i < count; i++) {
+            if (moves[i].from == from && moves[i].to == to && moves[i].numJumps == 0) {
+                _board.makeMove(moves[i]);
+                recordMove(i);
+                break;
+            }
         }
     }
 
-    _mustContinueJumping = false;
-    _jumpingPiece = nullptr;
+    resetHops();
+    syncGrid();
     endTurn();
 }
 
-bool Checkers::canJumpFrom(ChessSquare& square) const {
-    Bit* piece = square.bit();
-    if (!piece) return false;
-
-    int x = square.getColumn();
-    int y = square.getRow();
-    bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-    bool isRed = (piece->getOwner() == getPlayerAt(RED_PLAYER));
-    Player* player = piece->getOwner();
-
-    auto checkJumpDir = [&](ChessSquare* middle, ChessSquare* target) -> bool {
-        return middle && middle->bit() && middle->bit()->getOwner() != player &&
-               target && !target->bit();
-    };
-
-    if (isKing || !isRed) {
-        if (checkJumpDir(_grid->getFL(x, y), _grid->getFLFL(x, y))) return true;
-        if (checkJumpDir(_grid->getFR(x, y), _grid->getFRFR(x, y))) return true;
-    }
-    if (isKing || isRed) {
-        if (checkJumpDir(_grid->getBL(x, y), _grid->getBLBL(x, y))) return true;
-        if (checkJumpDir(_grid->getBR(x, y), _grid->getBRBR(x, y))) return true;
-    }
-    return false;
-}
-
-bool Checkers::hasJumpAvailable(Player* player) const {
-    bool hasJump = false;
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasJump) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == player) {
-            Checkers* self = const_cast<Checkers*>(this);
-            if (self->canJumpFrom(*square)) {
-                hasJump = true;
-            }
-        }
-    });
-    return hasJump;
-}
-
 Player* Checkers::checkForWinner() {
-    if (_redPieces == 0) return getPlayerAt(YELLOW_PLAYER);
-    if (_yellowPieces == 0) return getPlayerAt(RED_PLAYER);
-
-    // Check if current player has any moves
-    Player* current = getCurrentPlayer();
-    bool hasMove = false;
-
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (hasMove) return;
-        Bit* piece = square->bit();
-        if (piece && piece->getOwner() == current) {
-            bool isKing = (piece->gameTag() == RED_KING || piece->gameTag() == YELLOW_KING);
-            bool isRed = (current == getPlayerAt(RED_PLAYER));
-
-            // Check for any valid move
-            auto checkMove = [&](ChessSquare* target) {
-                if (target && !target->bit()) hasMove = true;
-            };
-
-            if (isKing) {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else if (isRed) {
-                checkMove(_grid->getBL(x, y));
-                checkMove(_grid->getBR(x, y));
-            } else {
-                checkMove(_grid->getFL(x, y));
-                checkMove(_grid->getFR(x, y));
-            }
-        }
-    });
-
-    if (!hasMove) {
-        return current == getPlayerAt(RED_PLAYER) ? getPlayerAt(YELLOW_PLAYER) : getPlayerAt(RED_PLAYER);
-    }
-    return nullptr;
+    // no pieces and no legal move both lose
+    int winner = _board.winner();
+    return winner < 0 ? nullptr : getPlayerAt(winner);
 }
 
 bool Checkers::checkForDraw() {
@@ -250,45 +200,65 @@ bool Checkers::checkForDraw() {
 }
 
 void Checkers::stopGame() {
-    _grid->forEachSquare([](ChessSquare* square, int x, int y) {
-        square->destroyBit();
-    });
-    _mustContinueJumping = false;
-    _jumpingPiece = nullptr;
-    _redPieces = 12;
-    _yellowPieces = 12;
+    releaseBits();
+    _board.reset();
+    resetHops();
 }
 
 std::string Checkers::initialStateString() {
-    return "111111111111--------333333333333";
+    // the same encoding as the state string, so startGame sees an untouched board as initial
+    return "11111111111100000000333333333333";
 }
 
-std::string Checkers::stateString() {
-    return _grid->getStateString();
+std::string Checkers::buildStateString() {
+    return _board.stateString();
 }
 
 void Checkers::setStateString(const std::string &s) {
-    if (s.length() != 32) return;
-
-    _redPieces = 0;
-    _yellowPieces = 0;
-
-    _grid->setStateString(s);
-
-    // Recreate pieces from state
-    size_t index = 0;
-    _grid->forEachEnabledSquare([&](ChessSquare* square, int x, int y) {
-        if (index < s.length()) {
-            int pieceType = s[index++] - '0';
-            if (pieceType != 0) {
-                Bit* piece = createPiece(pieceType);
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-                (pieceType == RED_PIECE || pieceType == RED_KING) ? _redPieces++ : _yellowPieces++;
-            }
-        }
-    });
+    if (!_board.setStateString(s)) return;
+
+    _board.setCurrentPlayer(_gameOptions.currentTurnNo & 1);
+    resetHops();
+    syncGrid();
 }
 
-void Checkers::updateAI() {}
+bool Checkers::prepareAIMove() {
+    // the human may have left a jump chain half done, the AI only starts from whole moves
+    if (_numHops > 0 || !_board.hasLegalMove()) return false;
 
+    _ai.setTableSize(_gameOptions.AITableSizeMB);
+    _searchBoard = _board;
+    _searchMaxDepth = getAIMAXDepth();
+    _searchTimeBudgetMs = _gameOptions.AITimeBudgetMs;
+    return true;
+}
+
+// runs on the AI worker thread
+int Checkers::searchAIMove(const std::atomic<bool> &cancel) {
+    int bestScore = 0;
+    _ai.setStopFlag(&cancel);
+    int move = _ai.search(_searchBoard, _searchMaxDepth, _searchTimeBudgetMs, bestScore);
+    _searchStats = _ai.stats();
+    return move;
+}
+
+void Checkers::applyAIMove(int move) {
+    // the board hasn't changed since the search started, so the move list is the same
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+    int count = _board.generateMoves(moves);
+    if (move >= count) return;
+
+    _board.makeMove(moves[move]);
+    recordMove(move);
+    resetHops();
+    syncGrid();
+    endTurn();
+}
+
+// moves are recorded as their index in the move list, which the position alone decides
+bool Checkers::replayMove(int move) {
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+    if (move < 0 || move >= _board.generateMoves(moves)) return false;
+    applyAIMove(move);
+    return true;
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "Game.h"
+#include "CheckersBoard.h"
+#include "CheckersAI.h"
 
 // NOTE: If Square class needs modifications to support colored squares for checkerboard pattern,
 // add a method like setColor(ImVec4 color) to Square class
@@ -8,14 +10,13 @@ class Checkers : public Game
 {
 public:
     Checkers();
-    ~Checkers();
+    ~Checkers() override;
 
     // Required virtual methods from Game base class
     void        setUpBoard() override;
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
     std::string initialStateString() override;
-    std::string stateString() override;
     void        setStateString(const std::string &s) override;
     bool        actionForEmptyHolder(BitHolder &holder) override;
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
@@ -24,41 +25,42 @@ public:
     void        bitMovedFromTo(Bit &bit, BitHolder &src, BitHolder &dst) override;
 
     // AI methods
-    void        updateAI() override;
-    bool        gameHasAI() override { return false; } // Set to true when AI is implemented
+    bool        gameHasAI() override { return true; }
     Grid* getGrid() override { return _grid; }
 
-private:
-    // Constants for piece types
-    static const int EMPTY = 0;
-    static const int RED_PIECE = 1;
-    static const int RED_KING = 2;
-    static const int YELLOW_PIECE = 3;
-    static const int YELLOW_KING = 4;
+protected:
+    std::string buildStateString() override;
+    bool        prepareAIMove() override;
+    int         searchAIMove(const std::atomic<bool> &cancel) override;
+    void        applyAIMove(int move) override;
+    bool        replayMove(int move) override;
 
+private:
     // Player constants
     static const int RED_PLAYER = 0;
     static const int YELLOW_PLAYER = 1;
 
     // Helper methods
     Bit*        createPiece(int pieceType);
-    int         getPieceType(const Bit& bit) const;
-    bool        isKing(const Bit& bit) const;
-    bool        isValidMove(int srcX, int srcY, int dstX, int dstY, Player* player) const;
-    bool        isJumpMove(int srcX, int srcY, int dstX, int dstY) const;
-    bool        hasJumpAvailable(Player* player) const;
-    bool        canJumpFrom(ChessSquare& square) const;
-    void        performJump(int srcX, int srcY, int dstX, int dstY);
-    void        promoteToKing(Bit& bit, int y);
-    void        getBoardPosition(BitHolder &holder, int &x, int &y) const;
-    bool        isValidSquare(int x, int y) const;
+    void        setPieceType(Bit* bit, int pieceType);
+    void        syncGrid();
+    int         squareOf(BitHolder &holder) const;
+    bool        matchesHops(const CheckersMove &move) const;
+    void        resetHops();
 
     // Board representation
     Grid*        _grid;
+    // the rules and state live here, the grid is only a view of it
+    CheckersBoard _board;
+    CheckersAI  _ai;
+    // what the worker thread searches, copied when the search starts
+    CheckersBoard _searchBoard;
+    int         _searchMaxDepth;
+    int         _searchTimeBudgetMs;
 
-    // Game state
-    bool        _mustContinueJumping;
-    BitHolder*  _jumpingPiece;
-    int         _redPieces;
-    int         _yellowPieces;
-};
\ No newline at end of file
+    // a jump chain the human is part way through, one drag per hop
+    // the board only changes once the whole move is known
+    int         _numHops;
+    int         _hopOrigin;
+    uint8_t     _hops[CheckersMove::MAX_JUMPS];
+};
@@ -0,0 +1,77 @@
+#include "CheckersAI.h"
+#include <bit>
+
+// evaluation weights
+static const int MAN_VALUE = 100;
+static const int KING_VALUE = 150;
+static const int ADVANCE_WEIGHT = 3;    // per row a man has moved towards its crown row
+static const int BACK_ROW_WEIGHT = 10;  // per man still guarding the crown row of the other side
+static const int CENTER_WEIGHT = 5;
+
+static const uint32_t RED_BACK_ROW = 0x0000000fu;       // row 0, where yellow is crowned
+static const uint32_t YELLOW_BACK_ROW = 0xf0000000u;    // row 7, where red is crowned
+static const uint32_t CENTER = 0x00066000u;             // the middle four squares of rows 3 and 4
+
+static uint32_t rowMask(int row)
+{
+    return 0xfu << (4 * row);
+}
+
+// no pieces or no moves loses
+bool CheckersSearchState::isTerminal(int ply, int &score) const
+{
+    if (board.hasLegalMove()) {
+        return false;
+    }
+    score = -(WIN_SCORE - ply);
+    return true;
+}
+
+int CheckersSearchState::evaluate() const
+{
+    return CheckersAI::evaluate(board);
+}
+
+//
+// the biggest captures first, then kings taken and crownings
+//
+int CheckersSearchState::orderScore(const Move &move, int) const
+{
+    return 4 * std::popcount(move.captured) + 2 * std::popcount(move.capturedKings) + (move.promotes ? 3 : 0);
+}
+
+int CheckersAI::search(const CheckersBoard &board, int maxDepth, int timeBudgetMs, int &bestScore)
+{
+    CheckersSearchState root;
+    root.board = board;
+    return _search.search(root, maxDepth, timeBudgetMs, bestScore);
+}
+
+int CheckersAI::evaluate(const CheckersBoard &board)
+{
+    int score[2] = {0, 0};
+    uint32_t kings = board.kings();
+
+    for (int player = 0; player < 2; player++) {
+        uint32_t pieces = board.pieces(player);
+        uint32_t men = pieces & ~kings;
+
+        // Material
+        score[player] += MAN_VALUE * std::popcount(men) + KING_VALUE * std::popcount(pieces & kings);
+
+        // Men closer to being crowned are worth a little more
+        for (int row = 1; row < 8; row++) {
+            int advanced = (player == 0) ? row : 7 - row;
+            score[player] += ADVANCE_WEIGHT * advanced * std::popcount(men & rowMask(row));
+        }
+
+        // Men left on the back row keep the other side from crowning
+        uint32_t backRow = (player == 0) ? RED_BACK_ROW : YELLOW_BACK_ROW;
+        score[player] += BACK_ROW_WEIGHT * std::popcount(men & backRow);
+
+        score[player] += CENTER_WEIGHT * std::popcount(pieces & CENTER);
+    }
+
+    int player = board.currentPlayer();
+    return score[player] - score[player ^ 1];
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include "CheckersBoard.h"
+#include "Search.h"
+#include <cstdint>
+#include <atomic>
+
+//
+// a CheckersBoard as Search<> sees it
+// a side with no move left has lost, and the position isn't quiet while the
+// side to move has a capture, which it must take
+//
+struct CheckersSearchState
+{
+    using Move = CheckersMove;
+
+    static const int MAX_MOVES = CheckersBoard::MAX_MOVES;
+    // a move is known by its first and last square, which is enough to order on
+    static const int MOVE_IDS = CheckersBoard::NUM_SQUARES * CheckersBoard::NUM_SQUARES;
+    static const int WIN_SCORE = 10000;
+
+    CheckersBoard board;
+
+    int         generateMoves(Move *moves) const { return board.generateMoves(moves); }
+    void        makeMove(Move &move) { board.makeMove(move); }
+    void        unmakeMove(const Move &move) { board.unmakeMove(move); }
+    bool        isTerminal(int ply, int &score) const;
+    bool        isQuiet() const { return !board.hasCapture(); }
+    int         evaluate() const;
+    uint64_t    key() const { return board.key(); }
+    int         moveId(const Move &move) const { return move.from * CheckersBoard::NUM_SQUARES + move.to; }
+    int         orderScore(const Move &move, int depth) const;
+    int         extension(const Move &) const { return 0; }
+    // first and last square, "from-to"
+    std::string moveName(const Move &move) const { return std::to_string(move.from) + "-" + std::to_string(move.to); }
+};
+static_assert(SearchState<CheckersSearchState>);
+
+
+//
+// alpha-beta search for checkers, Search<> over CheckersSearchState
+// works entirely on a CheckersBoard, making and taking back moves in place,
+// so it never touches the grid, the sprites or a state string
+//
+// the main search stops at its depth only once the position is quiet: while the
+// side to move has a capture quiescence keeps going
+//
+// the root move comes back as its index in CheckersBoard::generateMoves order,
+// which is the same for every copy of a position
+//
+class CheckersAI
+{
+public:
+    // scores at or beyond this are wins, reduced by the ply so quicker wins score higher
+    static const int WIN_SCORE = CheckersSearchState::WIN_SCORE;
+    // deepest ply the search will reach, quiescence included
+    static const int MAX_PLY = Search<CheckersSearchState>::MAX_PLY;
+
+    // iterative deepening up to maxDepth, stopping once timeBudgetMs runs out (0 means no limit)
+    // returns the index of the best move of the last completed iteration or -1 if there are no moves
+    int         search(const CheckersBoard &board, int maxDepth, int timeBudgetMs, int &bestScore);
+    // search the position to a fixed depth
+    int         bestMove(const CheckersBoard &board, int depth, int &bestScore) { return search(board, depth, 0, bestScore); }
+    // static evaluation from the point of view of the player to move
+    static int  evaluate(const CheckersBoard &board);
+
+    // nodes searched during the last search
+    uint64_t    nodes() const { return _search.nodes(); }
+    int         completedDepth() const { return _search.completedDepth(); }
+    // depth, cutoffs, table use and principal variation of the last search
+    const SearchStats &stats() const { return _search.stats(); }
+
+    // optional flag another thread can set to abandon the search
+    void        setStopFlag(const std::atomic<bool> *flag) { _search.setStopFlag(flag); }
+
+    // transposition table budget, the table is kept between moves
+    void        setTableSize(size_t megabytes) { _search.setTableSize(megabytes); }
+    void        clearTable() { _search.clearTable(); }
+
+private:
+    Search<CheckersSearchState> _search;
+};
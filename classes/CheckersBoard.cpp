@@ -0,0 +1,282 @@
+#include "CheckersBoard.h"
+#include <bit>
+
+// up-left, up-right, down-left, down-right
+static const int DIRECTION_DX[4] = {-1, 1, -1, 1};
+static const int DIRECTION_DY[4] = {-1, -1, 1, 1};
+
+// red men move down the board, yellow men move up, kings use all four
+static const int RED_DIRECTIONS[2] = {2, 3};
+static const int YELLOW_DIRECTIONS[2] = {0, 1};
+static const int KING_DIRECTIONS[4] = {0, 1, 2, 3};
+
+static const uint32_t RED_CROWN_ROW = 0xf0000000u;     // row 7
+static const uint32_t YELLOW_CROWN_ROW = 0x0000000fu;  // row 0
+
+//
+// one step in each direction for a whole bitboard at once
+// even rows start one column in, so the index offset of a diagonal step
+// depends on the row, and the edge columns lose their outward neighbour
+//
+static const uint32_t EVEN_ROWS = 0x0f0f0f0fu;
+static const uint32_t ODD_ROWS = 0xf0f0f0f0u;
+static const uint32_t LEFT_EDGE = 0x11111111u;     // first square of every row
+static const uint32_t RIGHT_EDGE = 0x88888888u;    // last square of every row
+
+static inline uint32_t stepUpLeft(uint32_t b)    { return ((b & EVEN_ROWS) >> 4) | ((b & ODD_ROWS & ~LEFT_EDGE) >> 5); }
+static inline uint32_t stepUpRight(uint32_t b)   { return ((b & EVEN_ROWS & ~RIGHT_EDGE) >> 3) | ((b & ODD_ROWS) >> 4); }
+static inline uint32_t stepDownLeft(uint32_t b)  { return ((b & EVEN_ROWS) << 4) | ((b & ODD_ROWS & ~LEFT_EDGE) << 3); }
+static inline uint32_t stepDownRight(uint32_t b) { return ((b & EVEN_ROWS & ~RIGHT_EDGE) << 5) | ((b & ODD_ROWS) << 4); }
+
+//
+// neighbouring and jump landing squares for every square and direction, -1 off the board
+//
+struct CheckersTables
+{
+    int neighbor[CheckersBoard::NUM_SQUARES][4];
+    int jump[CheckersBoard::NUM_SQUARES][4];
+
+    CheckersTables()
+    {
+        for (int square = 0; square < CheckersBoard::NUM_SQUARES; square++) {
+            int x, y;
+            CheckersBoard::coordinatesOf(square, x, y);
+            for (int dir = 0; dir < 4; dir++) {
+                neighbor[square][dir] = CheckersBoard::squareAt(x + DIRECTION_DX[dir], y + DIRECTION_DY[dir]);
+                jump[square][dir] = CheckersBoard::squareAt(x + 2 * DIRECTION_DX[dir], y + 2 * DIRECTION_DY[dir]);
+            }
+        }
+    }
+};
+
+static const CheckersTables TABLES;
+
+static void directionsFor(int player, bool king, const int *&dirs, int &numDirs)
+{
+    if (king) {
+        dirs = KING_DIRECTIONS;
+        numDirs = 4;
+    } else {
+        dirs = (player == 0) ? RED_DIRECTIONS : YELLOW_DIRECTIONS;
+        numDirs = 2;
+    }
+}
+
+int CheckersBoard::squareAt(int x, int y)
+{
+    if (x < 0 || x >= 8 || y < 0 || y >= 8 || ((x + y) & 1) == 0) return -1;
+    return y * 4 + x / 2;
+}
+
+void CheckersBoard::coordinatesOf(int square, int &x, int &y)
+{
+    y = square / 4;
+    x = (square % 4) * 2 + ((y & 1) ? 0 : 1);
+}
+
+void CheckersBoard::reset()
+{
+    _pieces[0] = 0x00000fffu;   // red on rows 0-2
+    _pieces[1] = 0xfff00000u;   // yellow on rows 5-7
+    _kings = 0;
+    _player = 0;
+}
+
+int CheckersBoard::pieceAt(int square) const
+{
+    uint32_t bit = squareMask(square);
+    bool king = (_kings & bit) != 0;
+    if (_pieces[0] & bit) return king ? RED_KING : RED_PIECE;
+    if (_pieces[1] & bit) return king ? YELLOW_KING : YELLOW_PIECE;
+    return EMPTY;
+}
+
+//
+// depth first search of every jump chain from a square; captured pieces stay on the
+// board until the move is made, so they block landings but can't be jumped twice
+//
+void CheckersBoard::addJumps(int square, bool king, uint32_t captured, uint32_t capturedKings,
+                             CheckersMove &move, CheckersMove *moves, int &count) const
+{
+    uint32_t opp = _pieces[_player ^ 1];
+    uint32_t blocked = occupied() & ~squareMask(move.from);
+    uint32_t crownRow = (_player == 0) ? RED_CROWN_ROW : YELLOW_CROWN_ROW;
+
+    const int *dirs;
+    int numDirs;
+    directionsFor(_player, king, dirs, numDirs);
+
+    bool extended = false;
+    for (int i = 0; i < numDirs; i++) {
+        int mid = TABLES.neighbor[square][dirs[i]];
+        int land = TABLES.jump[square][dirs[i]];
+        if (land < 0) continue;
+
+        uint32_t midBit = squareMask(mid);
+        if (!(opp & midBit) || (captured & midBit) || (blocked & squareMask(land))) continue;
+        if (move.numJumps >= CheckersMove::MAX_JUMPS || count >= MAX_MOVES) continue;
+
+        extended = true;
+        move.path[move.numJumps++] = (uint8_t)land;
+        uint32_t nowCaptured = captured | midBit;
+        uint32_t nowCapturedKings = capturedKings | (midBit & _kings);
+
+        if (!king && (crownRow & squareMask(land))) {
+            // crowning ends the move
+            CheckersMove &done = moves[count++];
+            done = move;
+            done.to = (uint8_t)land;
+            done.captured = nowCaptured;
+            done.capturedKings = nowCapturedKings;
+            done.promotes = true;
+        } else {
+            addJumps(land, king, nowCaptured, nowCapturedKings, move, moves, count);
+        }
+        move.numJumps--;
+    }
+
+    if (!extended && move.numJumps > 0 && count < MAX_MOVES) {
+        CheckersMove &done = moves[count++];
+        done = move;
+        done.to = (uint8_t)square;
+        done.captured = captured;
+        done.capturedKings = capturedKings;
+        done.promotes = false;
+    }
+}
+
+int CheckersBoard::generateMoves(CheckersMove *moves) const
+{
+    int count = 0;
+    uint32_t own = _pieces[_player];
+    uint32_t open = ~occupied();
+    uint32_t crownRow = (_player == 0) ? RED_CROWN_ROW : YELLOW_CROWN_ROW;
+
+    // jumps are mandatory, so only look at steps when there are none
+    for (uint32_t bits = jumpers(); bits; bits &= bits - 1) {
+        int square = std::countr_zero(bits);
+        CheckersMove move;
+        move.from = (uint8_t)square;
+        move.numJumps = 0;
+        addJumps(square, (_kings & squareMask(square)) != 0, 0, 0, move, moves, count);
+    }
+    if (count > 0) return count;
+
+    for (uint32_t bits = own; bits; bits &= bits - 1) {
+        int square = std::countr_zero(bits);
+        bool king = (_kings & squareMask(square)) != 0;
+
+        const int *dirs;
+        int numDirs;
+        directionsFor(_player, king, dirs, numDirs);
+
+        for (int i = 0; i < numDirs && count < MAX_MOVES; i++) {
+            int to = TABLES.neighbor[square][dirs[i]];
+            if (to < 0 || !(open & squareMask(to))) continue;
+
+            CheckersMove &move = moves[count++];
+            move.from = (uint8_t)square;
+            move.to = (uint8_t)to;
+            move.numJumps = 0;
+            move.captured = 0;
+            move.capturedKings = 0;
+            move.promotes = !king && (crownRow & squareMask(to));
+        }
+    }
+    return count;
+}
+
+uint32_t CheckersBoard::jumpers() const
+{
+    uint32_t own = _pieces[_player];
+    uint32_t opp = _pieces[_player ^ 1];
+    uint32_t open = ~occupied();
+    // red men move down, yellow men up, kings both ways
+    uint32_t down = (_player == 0) ? own : (own & _kings);
+    uint32_t up = (_player == 1) ? own : (own & _kings);
+
+    // step onto an opponent and then onto an empty square, then walk back to the jumper
+    uint32_t result = 0;
+    result |= stepUpRight(stepUpRight(stepDownLeft(stepDownLeft(down) & opp) & open));
+    result |= stepUpLeft(stepUpLeft(stepDownRight(stepDownRight(down) & opp) & open));
+    result |= stepDownRight(stepDownRight(stepUpLeft(stepUpLeft(up) & opp) & open));
+    result |= stepDownLeft(stepDownLeft(stepUpRight(stepUpRight(up) & opp) & open));
+    return result & own;
+}
+
+bool CheckersBoard::hasLegalMove() const
+{
+    uint32_t own = _pieces[_player];
+    uint32_t open = ~occupied();
+    uint32_t down = (_player == 0) ? own : (own & _kings);
+    uint32_t up = (_player == 1) ? own : (own & _kings);
+
+    uint32_t steps = stepDownLeft(down) | stepDownRight(down) | stepUpLeft(up) | stepUpRight(up);
+    return (steps & open) != 0 || hasCapture();
+}
+
+void CheckersBoard::makeMove(const CheckersMove &move)
+{
+    uint32_t fromBit = squareMask(move.from);
+    uint32_t toBit = squareMask(move.to);
+
+    // a king's jump chain can end where it started, so clear before setting
+    _pieces[_player] = (_pieces[_player] & ~fromBit) | toBit;
+    if (_kings & fromBit) {
+        _kings = (_kings & ~fromBit) | toBit;
+    } else if (move.promotes) {
+        _kings |= toBit;
+    }
+
+    _pieces[_player ^ 1] &= ~move.captured;
+    _kings &= ~move.captured;
+    _player ^= 1;
+}
+
+void CheckersBoard::unmakeMove(const CheckersMove &move)
+{
+    _player ^= 1;
+
+    uint32_t fromBit = squareMask(move.from);
+    uint32_t toBit = squareMask(move.to);
+
+    if (move.promotes) {
+        _kings &= ~toBit;
+    } else if (_kings & toBit) {
+        _kings = (_kings & ~toBit) | fromBit;
+    }
+    _pieces[_player] = (_pieces[_player] & ~toBit) | fromBit;
+
+    _pieces[_player ^ 1] |= move.captured;
+    _kings |= move.capturedKings;
+}
+
+bool CheckersBoard::setStateString(const std::string &s)
+{
+    if (s.length() != (size_t)NUM_SQUARES) return false;
+
+    _pieces[0] = 0;
+    _pieces[1] = 0;
+    _kings = 0;
+    _player = 0;
+    for (int square = 0; square < NUM_SQUARES; square++) {
+        uint32_t bit = squareMask(square);
+        switch (s[square] - '0') {
+            case RED_KING:      _kings |= bit; [[fallthrough]];
+            case RED_PIECE:     _pieces[0] |= bit; break;
+            case YELLOW_KING:   _kings |= bit; [[fallthrough]];
+            case YELLOW_PIECE:  _pieces[1] |= bit; break;
+            default: break;
+        }
+    }
+    return true;
+}
+
+std::string CheckersBoard::stateString() const
+{
+    std::string state(NUM_SQUARES, '0');
+    for (int square = 0; square < NUM_SQUARES; square++) {
+        state[square] = (char)('0' + pieceAt(square));
+    }
+    return state;
+}
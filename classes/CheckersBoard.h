@@ -0,0 +1,101 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <string>
+
+//
+// a complete checkers move: a single step, or a chain of jumps ending on 'to'
+// path holds every landing square of a jump chain so the view can replay it hop by hop
+//
+struct CheckersMove
+{
+    static const int MAX_JUMPS = 12;
+
+    uint8_t     from;
+    uint8_t     to;
+    uint8_t     numJumps;
+    uint8_t     path[MAX_JUMPS];
+    uint32_t    captured;       // every piece taken by the move
+    uint32_t    capturedKings;  // the kings among them, needed to take the move back
+    bool        promotes;
+};
+
+//
+// checkers rules on the 32 dark squares, with no grid or sprites attached
+// squares are numbered row by row from the top, four per row, in the same order
+// Grid walks the enabled squares so the state strings line up:
+//
+//   row 0:  .  0  .  1  .  2  .  3
+//   row 1:  4  .  5  .  6  .  7  .
+//   ...
+//   row 7: 28  . 29  . 30  . 31  .
+//
+// player 0 is red, starts on rows 0-2, moves down the board and goes first
+// captures are mandatory and a jump chain has to be followed to the end,
+// a man that reaches the far row is crowned and its move ends there
+//
+class CheckersBoard
+{
+public:
+    static const int NUM_SQUARES = 32;
+    static const int MAX_MOVES = 128;
+
+    // piece codes used by the state string and the game's bit tags
+    static const int EMPTY = 0;
+    static const int RED_PIECE = 1;
+    static const int RED_KING = 2;
+    static const int YELLOW_PIECE = 3;
+    static const int YELLOW_KING = 4;
+
+    CheckersBoard() { reset(); }
+
+    // standard starting position, red to move
+    void        reset();
+
+    int         currentPlayer() const { return _player; }
+    void        setCurrentPlayer(int player) { _player = player & 1; }
+    uint32_t    pieces(int player) const { return _pieces[player]; }
+    uint32_t    kings() const { return _kings; }
+    uint32_t    occupied() const { return _pieces[0] | _pieces[1]; }
+    int         pieceAt(int square) const;
+
+    // all legal moves for the player to move, jumps only if any jump exists
+    int         generateMoves(CheckersMove *moves) const;
+    bool        hasLegalMove() const;
+    // pieces of the player to move that can jump right now, straight from the bitboards
+    uint32_t    jumpers() const;
+    bool        hasCapture() const { return jumpers() != 0; }
+
+    // hash of the pieces and the player to move, for transposition tables
+    uint64_t    key() const
+    {
+        uint64_t h = (((uint64_t)_pieces[0] << 32) | _pieces[1]) * 0x9E3779B97F4A7C15ULL;
+        h ^= std::rotl((uint64_t)_kings * 0xC2B2AE3D27D4EB4FULL, 29);
+        h ^= h >> 32;
+        h *= 0xD6E8FEB86659FD93ULL;
+        h ^= h >> 29;
+        return h ^ (uint64_t)_player;
+    }
+
+    void        makeMove(const CheckersMove &move);
+    void        unmakeMove(const CheckersMove &move);
+
+    // the player to move loses with no pieces or no legal move, -1 while the game is on
+    int         winner() const { return hasLegalMove() ? -1 : (_player ^ 1); }
+
+    // 32 character strings of piece codes, anything else is an empty square
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+    // map between the 32 playable squares and 8x8 grid coordinates
+    static int  squareAt(int x, int y);
+    static void coordinatesOf(int square, int &x, int &y);
+    static uint32_t squareMask(int square) { return 1u << square; }
+
+private:
+    void        addJumps(int square, bool king, uint32_t captured, uint32_t capturedKings, CheckersMove &move, CheckersMove *moves, int &count) const;
+
+    uint32_t    _pieces[2];
+    uint32_t    _kings;
+    int         _player;
+};
@@ -1,12 +1,16 @@
 #pragma once
 #include "Game.h"
+#include "Connect4Position.h"
+#include "Connect4AI.h"
+#include "Connect4Solver.h"
+#include "Connect4Book.h"
 #include <cstdint>
 
 class Connect4 : public Game
 {
 public:
     Connect4();
-    ~Connect4();
+    ~Connect4() override;
 
     // set up the board
     void setUpBoard() override;
@@ -18,7 +22,6 @@ public:
     bool checkForDraw() override;
     
     std::string initialStateString() override;
-    std::string stateString() override;
     void setStateString(const std::string &s) override;
     
     // Grid accessor
@@ -26,31 +29,44 @@ public:
     
     // AI methods
     bool gameHasAI() override;
-    void updateAI() override;
     
     // Helper methods
     int getBestMoveColumn() const { return _bestMoveColumn; }
+    // play perfectly whenever the solver can prove the result within half the time budget,
+    // falling back to the heuristic search with the rest
+    void setSolverMode(bool enabled) { _solverMode = enabled; }
+    bool getSolverMode() const { return _solverMode; }
+    // proved value of the position the AI last moved from, OUTCOME_UNKNOWN if it wasn't solved
+    Connect4Solver::Outcome getSolvedOutcome() const { return _solvedOutcome; }
     void setAIPlayer(int playerNumber, bool isAI);
-    
-    // AI evaluation method
-    bool aiTestForTerminalState(std::string &state, Player *&winner);
-    int negamax(std::string &state, int depth, int alpha, int beta, char currentChar, char aiChar, char opponentChar);
-    int aiBoardEvaluation(const std::string &state, char aiChar, char opponentChar);
+    const Connect4Position& getPosition() const { return _position; }
+
+protected:
+    std::string buildStateString() override;
+    bool prepareAIMove() override;
+    int searchAIMove(const std::atomic<bool> &cancel) override;
+    void applyAIMove(int move) override;
+    bool replayMove(int move) override;
 
 private:
-    struct WinPattern {
-        int stride1;
-        int stride2;
-    };
-    
     Grid *_grid;
     int _bestMoveColumn;
-    uint64_t _boardRed;
-    uint64_t _boardYellow;
-    static const int NUM_PATTERNS = 4;
-    WinPattern _patterns[NUM_PATTERNS];
+    // player who connected four, -1 while nobody has; kept up to date as discs drop
+    int _winningPlayerIndex;
+    // the rules and state live here, the grid is only a view of it
+    Connect4Position _position;
+    Connect4AI _ai;
+    Connect4Solver _solver;
+    bool _solverMode;
+    Connect4Solver::Outcome _solvedOutcome;
+    // what the worker thread searches, copied when the search starts
+    Connect4Position _searchPosition;
+    int _searchMaxDepth;
+    int _searchTimeBudgetMs;
+    bool _searchSolve;
+    Connect4Solver::Outcome _searchOutcome;
     
     Bit* PieceForPlayer(const int playerNumber);
-    uint64_t boardToBitboard(const std::string& state, char player);
-    bool checkWinShift(uint64_t board);
+    void syncGrid();
+    void findWinner();
 };
\ No newline at end of file
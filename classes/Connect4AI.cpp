@@ -0,0 +1,498 @@
+#include "Connect4AI.h"
+#include <algorithm>
+#include <bit>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+// Move ordering - center columns first
+static const int COL_ORDER[Connect4Position::WIDTH] = {3, 2, 4, 1, 5, 0, 6};
+
+// ordering keys: the cells a move leaves us able to win on, then its history
+static const int THREAT_ORDER_SHIFT = 24;
+static const int MAX_HISTORY_ORDER = (1 << THREAT_ORDER_SHIFT) - 1;
+// a move right under one of the opponent's winning cells hands it the win
+static const int GIFT_ORDER_PENALTY = 64;
+
+// nodes between looks at the clock and the stop flags, a power of two
+static const uint64_t STOP_CHECK_NODES = 4096;
+
+static uint64_t bottomRowMask()
+{
+    uint64_t mask = 0;
+    for (int col = 0; col < Connect4Position::WIDTH; col++) {
+        mask |= Connect4Position::cellMask(col, 0);
+    }
+    return mask;
+}
+
+static const uint64_t BOTTOM_MASK = bottomRowMask();
+static const uint64_t BOARD_MASK = BOTTOM_MASK * ((1ULL << Connect4Position::HEIGHT) - 1);
+static const uint64_t CENTER_MASK = ((1ULL << Connect4Position::HEIGHT) - 1) << ((Connect4Position::WIDTH / 2) * Connect4Position::STRIDE);
+
+Connect4AI::Connect4AI()
+{
+    _numThreads = 1;
+    _endgame = nullptr;
+    _nodes = 0;
+    _completedDepth = 0;
+    _timeBudgetMs = 0;
+    _timed = false;
+    _abort = false;
+    _stopFlag = nullptr;
+}
+
+//
+// win scores count down with the ply from the root, the table stores them relative
+// to the node instead so a transposed win keeps the right distance
+//
+static int scoreToTable(int score, int ply)
+{
+    if (score >= Connect4AI::WIN_SCORE - Connect4Position::NUM_CELLS) return score + ply;
+    if (score <= -Connect4AI::WIN_SCORE + Connect4Position::NUM_CELLS) return score - ply;
+    return score;
+}
+
+static int scoreFromTable(int score, int ply)
+{
+    if (score >= Connect4AI::WIN_SCORE - Connect4Position::NUM_CELLS) return score - ply;
+    if (score <= -Connect4AI::WIN_SCORE + Connect4Position::NUM_CELLS) return score + ply;
+    return score;
+}
+
+int Connect4AI::search(const Connect4Position &position, int maxDepth, int timeBudgetMs, int &bestScore)
+{
+    auto start = std::chrono::steady_clock::now();
+    _stats = SearchStats();
+    _nodes = 0;
+    _completedDepth = 0;
+    _timeBudgetMs = timeBudgetMs;
+    _timed = false;
+    _abort = false;
+    _table.newSearch();
+
+    // no point looking past the end of the game
+    int emptyCells = Connect4Position::NUM_CELLS - position.moves();
+    maxDepth = std::min(std::max(maxDepth, 1), emptyCells);
+
+    _deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeBudgetMs);
+
+    std::vector<Worker> workers(_numThreads);
+    for (int i = 0; i < _numThreads; i++) {
+        workers[i].id = i;
+        workers[i].position = position;
+        workers[i].nodes = 0;
+        workers[i].cutoffs = 0;
+        workers[i].ttProbes = 0;
+        workers[i].ttHits = 0;
+        workers[i].stopped = false;
+        workers[i].completedDepth = 0;
+        workers[i].bestCol = -1;
+        workers[i].bestScore = 0;
+        std::memset(workers[i].history, 0, sizeof(workers[i].history));
+    }
+
+    // helpers search alongside this thread until it is done
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < _numThreads; i++) {
+        helpers.emplace_back([this, &workers, i, maxDepth]() { iterativeDeepening(workers[i], maxDepth); });
+    }
+    iterativeDeepening(workers[0], maxDepth);
+    _abort = true;
+    for (auto &helper : helpers) {
+        helper.join();
+    }
+
+    // take the deepest completed iteration, preferring the main thread on a tie
+    const Worker *best = &workers[0];
+    for (const Worker &worker : workers) {
+        _nodes += worker.nodes;
+        _stats.cutoffs += worker.cutoffs;
+        _stats.ttProbes += worker.ttProbes;
+        _stats.ttHits += worker.ttHits;
+        if (worker.bestCol >= 0 && worker.completedDepth > best->completedDepth) {
+            best = &worker;
+        }
+    }
+
+    _completedDepth = best->completedDepth;
+    bestScore = best->bestScore;
+
+    _stats.nodes = _nodes;
+    _stats.completedDepth = _completedDepth;
+    _stats.score = bestScore;
+    if (best->bestCol >= 0) {
+        collectPV(position, best->bestCol);
+    }
+    _stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return best->bestCol;
+}
+
+//
+// the best column, then the table's column from each position after it, for as deep
+// as the search completed; stops early where the table has lost the line
+//
+void Connect4AI::collectPV(const Connect4Position &root, int bestCol)
+{
+    Connect4Position position = root;
+    int col = bestCol;
+    for (int ply = 1; ply <= std::max(_completedDepth, 1); ply++) {
+        _stats.pv.push_back(std::to_string(col));
+        if (position.isWinningMove(col)) break;
+        position.play(col);
+
+        TranspositionTable::Entry entry;
+        if (ply == _completedDepth || position.isFull() || !_table.probe(position.key(), entry)) break;
+        col = entry.move;
+        if (col < 0 || col >= Connect4Position::WIDTH || !position.canPlay(col)) break;
+    }
+}
+
+void Connect4AI::iterativeDeepening(Worker &worker, int maxDepth)
+{
+    // odd helpers run a ply ahead of everyone else
+    for (int depth = 1 + (worker.id & 1); depth <= maxDepth; depth++) {
+        // the previous iteration's best move is searched first
+        int score = 0;
+        int col = searchRoot(worker, depth, worker.bestCol, score);
+        if (worker.stopped) break;
+
+        worker.bestCol = col;
+        worker.bestScore = score;
+        worker.completedDepth = depth;
+
+        // a forced win or loss won't change with more depth
+        if (std::abs(score) >= WIN_SCORE - Connect4Position::NUM_CELLS) break;
+
+        if (worker.id == 0) {
+            _timed = (_timeBudgetMs > 0);
+            if (_timed && std::chrono::steady_clock::now() >= _deadline) break;
+        }
+    }
+}
+
+bool Connect4AI::shouldStop(Worker &worker)
+{
+    // only look at the clock and the stop flags every few thousand nodes
+    if ((worker.nodes & (STOP_CHECK_NODES - 1)) == 0) {
+        if (worker.id == 0 && !_abort.load(std::memory_order_relaxed)) {
+            if (_stopFlag && _stopFlag->load(std::memory_order_relaxed)) {
+                _abort = true;
+            } else if (_timed.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() >= _deadline) {
+                _abort = true;
+            }
+        }
+        worker.stopped = _abort.load(std::memory_order_relaxed);
+    }
+    return worker.stopped;
+}
+
+//
+// columns best first into order[], returns how many: the table move, then the rest by
+// the threats they make and their history, ties going to the centre
+//
+// there are no killer moves, a column that refuted one move rarely refutes a sibling
+// once the stack under it has changed, and trying them early cost more nodes than it saved
+//
+int Connect4AI::orderMoves(const Worker &worker, uint64_t candidates, int ttCol, int *order) const
+{
+    const Connect4Position &position = worker.position;
+    int player = position.currentPlayer();
+    uint64_t mask = position.mask();
+    uint64_t mine = position.board(player);
+    uint64_t theirWins = winningCells(mine ^ mask, mask);
+
+    int keys[Connect4Position::WIDTH];
+    int count = 0;
+    for (int col : COL_ORDER) {
+        if (!position.canPlay(col)) continue;
+        uint64_t cell = candidates & Connect4Position::cellMask(col, position.height(col));
+        if (!cell) continue;
+
+        int key;
+        if (col == ttCol) {
+            key = INT_MAX;
+        } else {
+            int threats = std::popcount(winningCells(mine | cell, mask | cell));
+            if ((cell << 1) & theirWins) {
+                threats -= GIFT_ORDER_PENALTY;
+            }
+            int history = std::min(worker.history[player][std::countr_zero(cell)], MAX_HISTORY_ORDER);
+            key = threats * (1 << THREAT_ORDER_SHIFT) + history;
+        }
+
+        // insertion sort, COL_ORDER already settles ties towards the centre
+        int i = count++;
+        while (i > 0 && keys[i - 1] < key) {
+            keys[i] = keys[i - 1];
+            order[i] = order[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        order[i] = col;
+    }
+    return count;
+}
+
+// a move that caused a cutoff is worth trying early elsewhere
+void Connect4AI::rememberCutoff(Worker &worker, int col, int depth)
+{
+    const Connect4Position &position = worker.position;
+    worker.history[position.currentPlayer()][col * Connect4Position::STRIDE + position.height(col)] += depth * depth;
+}
+
+int Connect4AI::searchRoot(Worker &worker, int depth, int firstCol, int &bestScore)
+{
+    Connect4Position &position = worker.position;
+    int bestCol = -1;
+    int alpha = -INT_MAX;
+    bestScore = -INT_MAX;
+
+    // Search the previous best move first, otherwise the table move
+    int ttCol = firstCol;
+    TranspositionTable::Entry entry;
+    if (ttCol < 0) {
+        worker.ttProbes++;
+        if (_table.probe(position.key(), entry)) {
+            worker.ttHits++;
+            ttCol = entry.move;
+        }
+    }
+    int order[Connect4Position::WIDTH];
+    int count = orderMoves(worker, playableCells(position.mask()), ttCol, order);
+
+    for (int i = 0; i < count; i++) {
+        int col = order[i];
+        int score;
+        if (position.isWinningMove(col)) {
+            score = WIN_SCORE - 1;
+        } else {
+            position.play(col);
+            if (bestCol < 0) {
+                score = -negamax(worker, depth - 1, -INT_MAX, -alpha, 1);
+            } else {
+                // prove the rest are no better with a null window, search again if one is
+                score = -negamax(worker, depth - 1, -alpha - 1, -alpha, 1);
+                if (score > alpha && !worker.stopped) {
+                    score = -negamax(worker, depth - 1, -INT_MAX, -alpha, 1);
+                }
+            }
+            position.undo(col);
+        }
+        if (worker.stopped) return bestCol;
+
+        if (bestCol < 0 || score > bestScore) {
+            bestScore = score;
+            bestCol = col;
+        }
+        alpha = std::max(alpha, score);
+    }
+
+    if (bestCol >= 0) {
+        _table.store(position.key(), depth, TranspositionTable::BOUND_EXACT, scoreToTable(bestScore, 0), bestCol);
+    }
+    return bestCol;
+}
+
+int Connect4AI::negamax(Worker &worker, int depth, int alpha, int beta, int ply)
+{
+    Connect4Position &position = worker.position;
+
+    worker.nodes++;
+    if (shouldStop(worker)) {
+        return 0; // result is thrown away
+    }
+
+    if (position.isFull()) {
+        return 0; // Draw
+    }
+
+    uint64_t mask = position.mask();
+    uint64_t mine = position.board(position.currentPlayer());
+    uint64_t playable = playableCells(mask);
+
+    // Take an immediate win before searching anything else
+    if (winningCells(mine, mask) & playable) {
+        return WIN_SCORE - (ply + 1);
+    }
+
+    // A win the opponent threatens has to be blocked, and two of them can't be
+    uint64_t theirWins = winningCells(mine ^ mask, mask);
+    uint64_t forced = theirWins & playable;
+    if (forced & (forced - 1)) {
+        return -(WIN_SCORE - (ply + 2));
+    }
+    // never play right under one of their winning cells, that hands them the game
+    uint64_t candidates = (forced ? forced : playable) & ~(theirWins >> 1);
+    if (!candidates) {
+        return -(WIN_SCORE - (ply + 2));
+    }
+
+    // The endgame table's values are exact, however much depth is left
+    int empties = Connect4Position::NUM_CELLS - position.moves();
+    Connect4EndgameDB::Value value;
+    if (_endgame && empties <= _endgame->maxEmpties() && _endgame->probe(position, value)) {
+        // the table doesn't know how long a win takes, only that it comes by the last cell
+        if (value == Connect4EndgameDB::VALUE_WIN) return WIN_SCORE - (ply + empties);
+        if (value == Connect4EndgameDB::VALUE_LOSS) return -(WIN_SCORE - (ply + empties));
+        return 0;
+    }
+
+    if (depth <= 0) {
+        return evaluate(position);
+    }
+
+    // Transposition table: cut off on a deep enough result, otherwise just use its move
+    uint64_t key = position.key();
+    int ttMove = -1;
+    TranspositionTable::Entry entry;
+    worker.ttProbes++;
+    if (_table.probe(key, entry)) {
+        worker.ttHits++;
+        ttMove = entry.move;
+        if (entry.depth >= depth) {
+            int score = scoreFromTable(entry.score, ply);
+            if (entry.bound == TranspositionTable::BOUND_EXACT) return score;
+            if (entry.bound == TranspositionTable::BOUND_LOWER && score >= beta) return score;
+            if (entry.bound == TranspositionTable::BOUND_UPPER && score <= alpha) return score;
+        }
+    }
+
+    int order[Connect4Position::WIDTH];
+    int count = orderMoves(worker, candidates, ttMove, order);
+
+    int alphaOrig = alpha;
+    int maxScore = -INT_MAX;
+    int bestCol = -1;
+
+    for (int i = 0; i < count; i++) {
+        int col = order[i];
+        position.play(col);
+        int score;
+        if (i == 0) {
+            score = -negamax(worker, depth - 1, -beta, -alpha, ply + 1);
+        } else {
+            score = -negamax(worker, depth - 1, -alpha - 1, -alpha, ply + 1);
+            if (score > alpha && score < beta && !worker.stopped) {
+                score = -negamax(worker, depth - 1, -beta, -alpha, ply + 1);
+            }
+        }
+        position.undo(col);
+        if (worker.stopped) return 0;
+
+        if (score > maxScore) {
+            maxScore = score;
+            bestCol = col;
+        }
+
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            worker.cutoffs++;
+            rememberCutoff(worker, col, depth);
+            break; // Alpha-beta pruning
+        }
+    }
+
+    TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+    if (maxScore <= alphaOrig) {
+        bound = TranspositionTable::BOUND_UPPER;
+    } else if (maxScore >= beta) {
+        bound = TranspositionTable::BOUND_LOWER;
+    }
+    _table.store(key, depth, bound, scoreToTable(maxScore, ply), bestCol);
+
+    return maxScore;
+}
+
+int Connect4SearchState::generateMoves(Move *moves) const
+{
+    int count = 0;
+    for (int i = 0; i < Connect4Position::WIDTH; i++) {
+        if (position.canPlay(COL_ORDER[i])) {
+            moves[count++] = COL_ORDER[i];
+        }
+    }
+    return count;
+}
+
+// the player who just moved connected four, or the board filled up for a draw
+bool Connect4SearchState::isTerminal(int ply, int &score) const
+{
+    if (position.lastMoveWon()) {
+        score = -(WIN_SCORE - ply);
+        return true;
+    }
+    if (position.isFull()) {
+        score = 0;
+        return true;
+    }
+    return false;
+}
+
+//
+// a winning drop first, then the centre columns
+//
+int Connect4SearchState::orderScore(const Move &col, int) const
+{
+    if (position.isWinningMove(col)) {
+        return Connect4Position::WIDTH;
+    }
+    return Connect4Position::WIDTH / 2 - std::abs(col - Connect4Position::WIDTH / 2);
+}
+
+uint64_t Connect4AI::winningCells(uint64_t board, uint64_t mask)
+{
+    const int S = Connect4Position::STRIDE;
+
+    // vertical
+    uint64_t r = (board << 1) & (board << 2) & (board << 3);
+
+    // horizontal
+    uint64_t p = (board << S) & (board << 2 * S);
+    r |= p & (board << 3 * S);
+    r |= p & (board >> S);
+    p = (board >> S) & (board >> 2 * S);
+    r |= p & (board << S);
+    r |= p & (board >> 3 * S);
+
+    // diagonal going down to the right
+    p = (board << (S - 1)) & (board << 2 * (S - 1));
+    r |= p & (board << 3 * (S - 1));
+    r |= p & (board >> (S - 1));
+    p = (board >> (S - 1)) & (board >> 2 * (S - 1));
+    r |= p & (board << (S - 1));
+    r |= p & (board >> 3 * (S - 1));
+
+    // diagonal going up to the right
+    p = (board << (S + 1)) & (board << 2 * (S + 1));
+    r |= p & (board << 3 * (S + 1));
+    r |= p & (board >> (S + 1));
+    p = (board >> (S + 1)) & (board >> 2 * (S + 1));
+    r |= p & (board << (S + 1));
+    r |= p & (board >> 3 * (S + 1));
+
+    return r & (BOARD_MASK ^ mask);
+}
+
+uint64_t Connect4AI::playableCells(uint64_t mask)
+{
+    return (mask + BOTTOM_MASK) & BOARD_MASK;
+}
+
+int Connect4AI::evaluate(const Connect4Position &position)
+{
+    uint64_t mask = position.mask();
+    uint64_t mine = position.board(position.currentPlayer());
+    uint64_t theirs = mine ^ mask;
+
+    int score = 0;
+
+    // Center column preference (strategic advantage)
+    score += 3 * (std::popcount(mine & CENTER_MASK) - std::popcount(theirs & CENTER_MASK));
+
+    // Open three-in-a-rows, counted by the empty cells that would complete them
+    score += 50 * (std::popcount(winningCells(mine, mask)) - std::popcount(winningCells(theirs, mask)));
+
+    return score;
+}
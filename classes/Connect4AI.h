@@ -0,0 +1,130 @@
+#pragma once
+#include "Connect4Position.h"
+#include "TranspositionTable.h"
+#include "Connect4EndgameDB.h"
+#include "Search.h"
+#include "SearchStats.h"
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+#include <vector>
+
+//
+// negamax search for connect 4
+// works entirely on a Connect4Position, making and taking back moves in place,
+// so it never touches the grid, the sprites or a state string
+//
+// searches can run on several threads at once (lazy SMP): every thread runs its own
+// iterative deepening over the same position, sharing only the transposition table,
+// and helpers start on staggered depths so they fill the table ahead of the main thread
+//
+class Connect4AI
+{
+public:
+    // scores at or beyond this are wins, reduced by the ply so quicker wins score higher
+    static const int WIN_SCORE = 1000;
+
+    Connect4AI();
+
+    // iterative deepening up to maxDepth, stopping once timeBudgetMs runs out (0 means no limit)
+    // returns the best column of the last completed iteration or -1 if there are no moves
+    int         search(const Connect4Position &position, int maxDepth, int timeBudgetMs, int &bestScore);
+    // search the position to a fixed depth
+    int         bestMove(const Connect4Position &position, int depth, int &bestScore) { return search(position, depth, 0, bestScore); }
+    // static evaluation from the point of view of the player to move
+    static int  evaluate(const Connect4Position &position);
+
+    // nodes searched by all threads during the last search
+    uint64_t    nodes() const { return _nodes; }
+    int         completedDepth() const { return _completedDepth; }
+    // depth, cutoffs, table use and principal variation of the last search, summed over the threads
+    const SearchStats &stats() const { return _stats; }
+
+    // number of search threads, including the calling one
+    void        setThreads(int threads) { _numThreads = threads < 1 ? 1 : threads; }
+    int         threads() const { return _numThreads; }
+
+    // optional flag another thread can set to abandon the search
+    void        setStopFlag(const std::atomic<bool> *flag) { _stopFlag = flag; }
+
+    // transposition table budget, the table is kept between moves
+    void        setTableSize(size_t megabytes) { _table.resize(megabytes); }
+    void        clearTable() { _table.clear(); }
+
+    // optional table of exact late game values, used in place of searching what it holds
+    void        setEndgameDB(const Connect4EndgameDB *endgame) { _endgame = endgame; }
+
+    // empty cells that would complete four in a row for the given stones
+    static uint64_t winningCells(uint64_t board, uint64_t mask);
+    // the lowest empty cell of every column that isn't full
+    static uint64_t playableCells(uint64_t mask);
+
+private:
+    // everything one search thread owns, the history included so threads never share it
+    struct Worker {
+        int                 id;
+        Connect4Position    position;
+        uint64_t            nodes;
+        uint64_t            cutoffs;
+        uint64_t            ttProbes;
+        uint64_t            ttHits;
+        bool                stopped;
+        int                 completedDepth;
+        int                 bestCol;
+        int                 bestScore;
+        // cutoffs by player and cell, so a column scores differently as it fills
+        int                 history[2][Connect4Position::WIDTH * Connect4Position::STRIDE];
+    };
+
+    void        iterativeDeepening(Worker &worker, int maxDepth);
+    int         searchRoot(Worker &worker, int depth, int firstCol, int &bestScore);
+    int         negamax(Worker &worker, int depth, int alpha, int beta, int ply);
+    int         orderMoves(const Worker &worker, uint64_t candidates, int ttCol, int *order) const;
+    void        rememberCutoff(Worker &worker, int col, int depth);
+    bool        shouldStop(Worker &worker);
+    void        collectPV(const Connect4Position &position, int bestCol);
+
+    TranspositionTable  _table;
+    const Connect4EndgameDB *_endgame;
+    int                 _numThreads;
+    uint64_t            _nodes;
+    int                 _completedDepth;
+    SearchStats         _stats;
+    // time control, only armed once the main thread has a move
+    int                 _timeBudgetMs;
+    std::atomic<bool>   _timed;
+    std::atomic<bool>   _abort;
+    std::chrono::steady_clock::time_point _deadline;
+    const std::atomic<bool> *_stopFlag;
+};
+
+//
+// a Connect4Position as Search<> sees it
+// the game itself keeps the multi-threaded engine above, this is for single
+// threaded searches that want the shared framework's killer and history ordering
+//
+struct Connect4SearchState
+{
+    using Move = int;   // the column
+
+    static const int MAX_MOVES = Connect4Position::WIDTH;
+    static const int MOVE_IDS = Connect4Position::WIDTH;
+    // well clear of anything evaluate() returns, which Connect4AI::WIN_SCORE isn't past Search<>::MAX_PLY
+    static const int WIN_SCORE = 10000;
+
+    Connect4Position position;
+
+    int         generateMoves(Move *moves) const;
+    void        makeMove(Move &col) { position.play(col); }
+    void        unmakeMove(const Move &col) { position.undo(col); }
+    bool        isTerminal(int ply, int &score) const;
+    bool        isQuiet() const { return true; }
+    int         evaluate() const { return Connect4AI::evaluate(position); }
+    uint64_t    key() const { return position.key(); }
+    int         moveId(const Move &col) const { return col; }
+    int         orderScore(const Move &col, int depth) const;
+    int         extension(const Move &) const { return 0; }
+    std::string moveName(const Move &col) const { return std::to_string(col); }
+};
+static_assert(SearchState<Connect4SearchState>);
+
@@ -0,0 +1,97 @@
+#include "Connect4Book.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+Connect4Book::Connect4Book()
+{
+    _entries = nullptr;
+    _count = 0;
+    _maxPly = 0;
+}
+
+bool Connect4Book::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path)) {
+        return false;
+    }
+
+    Header header;
+    if (_file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    if (std::memcmp(header.magic, "C4BK", 4) != 0 || header.version != VERSION
+        || _file.size() != sizeof(Header) + (size_t)header.count * sizeof(uint64_t)) {
+        close();
+        return false;
+    }
+
+    // the header is 16 bytes, so the entries stay 8 byte aligned in the mapping
+    _entries = (const uint64_t *)(_file.data() + sizeof(Header));
+    _count = header.count;
+    _maxPly = (int)header.maxPly;
+    return true;
+}
+
+void Connect4Book::close()
+{
+    _file.close();
+    _entries = nullptr;
+    _count = 0;
+    _maxPly = 0;
+}
+
+bool Connect4Book::probe(const Connect4Position &position, int &col, int &score) const
+{
+    if (!_entries || position.moves() > _maxPly) {
+        return false;
+    }
+
+    uint64_t key = position.key();
+    uint64_t mirrored = Connect4Position::mirrorKey(key);
+    bool flip = mirrored < key;
+    uint64_t wanted = flip ? mirrored : key;
+
+    const uint64_t *end = _entries + _count;
+    const uint64_t *it = std::lower_bound(_entries, end, wanted,
+                                          [](uint64_t entry, uint64_t k) { return (entry & KEY_MASK) < k; });
+    if (it == end || (*it & KEY_MASK) != wanted) {
+        return false;
+    }
+
+    col = (int)((*it >> COL_SHIFT) & 0x7);
+    score = (int)((int64_t)*it >> SCORE_SHIFT);
+    if (flip) {
+        col = Connect4Position::WIDTH - 1 - col;
+    }
+    return position.canPlay(col);
+}
+
+uint64_t Connect4Book::packEntry(uint64_t key, int col, int score)
+{
+    // twelve bits hold the score, which covers every connect 4 score the engine gives
+    score = std::clamp(score, -2048, 2047);
+    return (key & KEY_MASK) | ((uint64_t)col << COL_SHIFT) | ((uint64_t)(int64_t)score << SCORE_SHIFT);
+}
+
+bool Connect4Book::write(const std::string &path, int maxPly, std::vector<uint64_t> &entries)
+{
+    std::sort(entries.begin(), entries.end(), [](uint64_t a, uint64_t b) { return (a & KEY_MASK) < (b & KEY_MASK); });
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, "C4BK", 4);
+    header.version = VERSION;
+    header.maxPly = (uint32_t)maxPly;
+    header.count = (uint32_t)entries.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+           && std::fwrite(entries.data(), sizeof(uint64_t), entries.size(), file) == entries.size();
+    return std::fclose(file) == 0 && ok;
+}
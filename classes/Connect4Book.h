@@ -0,0 +1,61 @@
+#pragma once
+#include "Connect4Position.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// connect 4 opening book, memory mapped straight from disk and never parsed
+//
+// the file is a small header followed by one little endian 64 bit word per position,
+// sorted on the key so a probe is a binary search:
+//
+//   bits  0-48     Connect4Position::key() of the position or its mirror image, whichever is smaller
+//   bits 49-51     best column, for that (possibly mirrored) position
+//   bits 52-63     score the engine gave it, signed
+//
+// storing only one of each mirrored pair halves the book; tools/connect4book writes it
+//
+class Connect4Book
+{
+public:
+    static const uint32_t VERSION = 1;
+
+    Connect4Book();
+
+    // map a book file, false if it is missing or not a book
+    bool        open(const std::string &path);
+    void        close();
+
+    bool        isOpen() const { return _entries != nullptr; }
+    size_t      size() const { return _count; }
+    // book positions go this many moves into the game
+    int         maxPly() const { return _maxPly; }
+
+    // best column and score for the player to move, false if the position isn't in the book
+    bool        probe(const Connect4Position &position, int &col, int &score) const;
+
+    // one entry as it is stored, key has to be the smaller of the position's key and its mirror's
+    static uint64_t packEntry(uint64_t key, int col, int score);
+    // sort and write a book, false if the file can't be written
+    static bool     write(const std::string &path, int maxPly, std::vector<uint64_t> &entries);
+
+private:
+    struct Header {
+        char        magic[4];   // "C4BK"
+        uint32_t    version;
+        uint32_t    maxPly;
+        uint32_t    count;
+    };
+
+    static const int        KEY_BITS = Connect4Position::WIDTH * Connect4Position::STRIDE;
+    static const uint64_t   KEY_MASK = (1ULL << KEY_BITS) - 1;
+    static const int        COL_SHIFT = KEY_BITS;
+    static const int        SCORE_SHIFT = KEY_BITS + 3;
+
+    MappedFile          _file;
+    const uint64_t     *_entries;
+    size_t              _count;
+    int                 _maxPly;
+};
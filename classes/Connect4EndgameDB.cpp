@@ -0,0 +1,143 @@
+#include "Connect4EndgameDB.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+Connect4EndgameDB::Connect4EndgameDB()
+{
+    _blocks = nullptr;
+    _codes = nullptr;
+    _numBlocks = 0;
+    _dataBytes = 0;
+    _count = 0;
+    _maxEmpties = 0;
+}
+
+bool Connect4EndgameDB::open(const std::string &path)
+{
+    close();
+    if (!_file.open(path)) {
+        return false;
+    }
+
+    Header header;
+    if (_file.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header, _file.data(), sizeof(Header));
+    size_t expected = sizeof(Header) + (size_t)header.numBlocks * sizeof(Block) + header.dataBytes;
+    if (std::memcmp(header.magic, "C4EG", 4) != 0 || header.version != VERSION
+        || header.blockSize != BLOCK_SIZE || _file.size() != expected) {
+        close();
+        return false;
+    }
+
+    // the header and blocks are multiples of 8 bytes, so the index stays aligned in the mapping
+    _blocks = (const Block *)(_file.data() + sizeof(Header));
+    _codes = _file.data() + sizeof(Header) + (size_t)header.numBlocks * sizeof(Block);
+    _numBlocks = header.numBlocks;
+    _dataBytes = (size_t)header.dataBytes;
+    _count = header.count;
+    _maxEmpties = (int)header.maxEmpties;
+    return true;
+}
+
+void Connect4EndgameDB::close()
+{
+    _file.close();
+    _blocks = nullptr;
+    _codes = nullptr;
+    _numBlocks = 0;
+    _dataBytes = 0;
+    _count = 0;
+    _maxEmpties = 0;
+}
+
+bool Connect4EndgameDB::probe(const Connect4Position &position, Value &value) const
+{
+    if (!_blocks || _numBlocks == 0 || Connect4Position::NUM_CELLS - position.moves() > _maxEmpties) {
+        return false;
+    }
+
+    uint64_t key = position.key();
+    key = std::min(key, Connect4Position::mirrorKey(key));
+
+    // the last block starting at or before the key
+    const Block *end = _blocks + _numBlocks;
+    const Block *block = std::upper_bound(_blocks, end, key,
+                                          [](uint64_t k, const Block &b) { return k < b.firstKey; });
+    if (block == _blocks) {
+        return false;
+    }
+    block--;
+
+    uint64_t current = block->firstKey;
+    int code = block->firstValue;
+    const uint8_t *p = _codes + block->offset;
+    const uint8_t *limit = _codes + _dataBytes;
+    for (int i = 1; current < key && i < block->count; i++) {
+        uint64_t delta = 0;
+        int shift = 0;
+        uint8_t byte;
+        do {
+            if (p >= limit) return false;
+            byte = *p++;
+            delta |= (uint64_t)(byte & 0x7f) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        current += delta >> 2;
+        code = (int)(delta & 3) - 1;
+    }
+
+    if (current != key) {
+        return false;
+    }
+    value = (Value)code;
+    return true;
+}
+
+bool Connect4EndgameDB::write(const std::string &path, int maxEmpties, std::vector<Entry> &entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key == b.key; }),
+                  entries.end());
+
+    std::vector<Block> blocks;
+    std::vector<uint8_t> codes;
+    for (size_t i = 0; i < entries.size(); i += BLOCK_SIZE) {
+        size_t last = std::min(i + BLOCK_SIZE, entries.size());
+        Block block = {};
+        block.firstKey = entries[i].key;
+        block.offset = (uint32_t)codes.size();
+        block.firstValue = entries[i].value;
+        block.count = (uint8_t)(last - i);
+        for (size_t n = i + 1; n < last; n++) {
+            uint64_t code = ((entries[n].key - entries[n - 1].key) << 2) | (uint64_t)(entries[n].value + 1);
+            do {
+                uint8_t byte = code & 0x7f;
+                code >>= 7;
+                codes.push_back(code ? (byte | 0x80) : byte);
+            } while (code);
+        }
+        blocks.push_back(block);
+    }
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    Header header;
+    std::memcpy(header.magic, "C4EG", 4);
+    header.version = VERSION;
+    header.maxEmpties = (uint32_t)maxEmpties;
+    header.count = (uint32_t)entries.size();
+    header.numBlocks = (uint32_t)blocks.size();
+    header.blockSize = BLOCK_SIZE;
+    header.dataBytes = codes.size();
+
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+           && std::fwrite(blocks.data(), sizeof(Block), blocks.size(), file) == blocks.size()
+           && std::fwrite(codes.data(), 1, codes.size(), file) == codes.size();
+    return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Connect4Position.h"
+#include "MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// exact win/draw/loss values of late connect 4 positions, memory mapped from disk
+//
+// positions are stored by key (the smaller of the position's and its mirror's),
+// sorted, and cut into blocks of BLOCK_SIZE; each block starts with its first key in
+// an index that is binary searched, and the rest of the block is a byte stream of
+// variable length codes, one per position:
+//
+//   (key - previous key) << 2 | value     LEB128, 7 bits per byte
+//
+// where value is 0 for a loss, 1 a draw and 2 a win for the player to move; sorted
+// keys sit close together, so most positions take two or three bytes instead of nine
+//
+// tools/connect4endgame writes the file
+//
+class Connect4EndgameDB
+{
+public:
+    static const uint32_t VERSION = 1;
+    static const int BLOCK_SIZE = 64;
+
+    // value for the player to move, the same as Connect4Solver::Outcome
+    enum Value : int8_t {
+        VALUE_LOSS = -1,
+        VALUE_DRAW = 0,
+        VALUE_WIN = 1
+    };
+
+    Connect4EndgameDB();
+
+    // map a table file, false if it is missing or not a table
+    bool        open(const std::string &path);
+    void        close();
+
+    bool        isOpen() const { return _blocks != nullptr; }
+    size_t      size() const { return _count; }
+    // positions with more empty cells than this are never in the table
+    int         maxEmpties() const { return _maxEmpties; }
+
+    // false if the position isn't in the table
+    bool        probe(const Connect4Position &position, Value &value) const;
+
+    // one position to write, key has to be the smaller of the position's key and its mirror's
+    struct Entry {
+        uint64_t    key;
+        Value       value;
+    };
+    // sort and write a table, false if the file can't be written
+    static bool write(const std::string &path, int maxEmpties, std::vector<Entry> &entries);
+
+private:
+    struct Header {
+        char        magic[4];   // "C4EG"
+        uint32_t    version;
+        uint32_t    maxEmpties;
+        uint32_t    count;
+        uint32_t    numBlocks;
+        uint32_t    blockSize;
+        uint64_t    dataBytes;
+    };
+
+    struct Block {
+        uint64_t    firstKey;
+        uint32_t    offset;     // into the code stream, for the positions after the first
+        int8_t      firstValue;
+        uint8_t     count;      // positions in the block, the first included
+        uint8_t     pad[2];
+    };
+
+    MappedFile          _file;
+    const Block        *_blocks;
+    const uint8_t      *_codes;
+    size_t              _numBlocks;
+    size_t              _dataBytes;
+    size_t              _count;
+    int                 _maxEmpties;
+};
@@ -0,0 +1,34 @@
+#include "Connect4Position.h"
+
+//
+// state strings are row-major with the top row first, '1' for red and '2' for yellow
+//
+bool Connect4Position::setStateString(const std::string &s)
+{
+    reset();
+    if (s.length() < (size_t)NUM_CELLS) return false;
+
+    for (int col = 0; col < WIDTH; col++) {
+        // stack pieces from the bottom up, a gap ends the column
+        for (int row = 0; row < HEIGHT; row++) {
+            char c = s[(HEIGHT - 1 - row) * WIDTH + col];
+            if (c != '1' && c != '2') break;
+            _boards[c == '1' ? 0 : 1] |= cellMask(col, row);
+            _height[col]++;
+            _moves++;
+        }
+    }
+    return true;
+}
+
+std::string Connect4Position::stateString() const
+{
+    std::string state(NUM_CELLS, '0');
+    for (int col = 0; col < WIDTH; col++) {
+        for (int row = 0; row < _height[col]; row++) {
+            uint64_t bit = cellMask(col, row);
+            state[(HEIGHT - 1 - row) * WIDTH + col] = (_boards[0] & bit) ? '1' : '2';
+        }
+    }
+    return state;
+}
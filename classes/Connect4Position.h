@@ -0,0 +1,129 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <string>
+
+//
+// compact connect 4 position used by the AI
+// two bitboards (one per player) plus the height of every column, so playing
+// and taking back a move is a couple of bit operations and never allocates
+//
+// bits are laid out column by column with one spare bit on top of each column:
+//
+//   6 13 20 27 34 41 48   <- spare row, always empty
+//   5 12 19 26 33 40 47   <- top row
+//   4 11 18 25 32 39 46
+//   3 10 17 24 31 38 45
+//   2  9 16 23 30 37 44
+//   1  8 15 22 29 36 43
+//   0  7 14 21 28 35 42   <- bottom row
+//
+// which keeps lines from wrapping and gives shifts of 1 (vertical), 7 (horizontal),
+// 6 and 8 (diagonals) for the four-in-a-row tests
+//
+class Connect4Position
+{
+public:
+    static const int WIDTH = 7;
+    static const int HEIGHT = 6;
+    static const int STRIDE = HEIGHT + 1;
+    static const int NUM_CELLS = WIDTH * HEIGHT;
+
+    Connect4Position() { reset(); }
+
+    void reset()
+    {
+        _boards[0] = 0;
+        _boards[1] = 0;
+        _moves = 0;
+        for (int col = 0; col < WIDTH; col++) {
+            _height[col] = 0;
+        }
+    }
+
+    // player 0 is red and always moves first
+    int         currentPlayer() const { return _moves & 1; }
+    int         moves() const { return _moves; }
+    int         height(int col) const { return _height[col]; }
+    uint64_t    board(int player) const { return _boards[player]; }
+    uint64_t    mask() const { return _boards[0] | _boards[1]; }
+    bool        isFull() const { return _moves == NUM_CELLS; }
+    // unique key for the position: the side to move's stones plus the occupied mask
+    // a column of h stones adds up to a value in [2^h - 1, 2^(h+1) - 2], so the stack height
+    // and its stones can both be read back, and at most 126 it never carries into the next
+    // column; the side to move follows from the stone count
+    uint64_t    key() const { return _boards[_moves & 1] + mask(); }
+
+    bool canPlay(int col) const { return _height[col] < HEIGHT; }
+
+    void play(int col)
+    {
+        _boards[_moves & 1] |= cellMask(col, _height[col]++);
+        _moves++;
+    }
+
+    void undo(int col)
+    {
+        _moves--;
+        _boards[_moves & 1] ^= cellMask(col, --_height[col]);
+    }
+
+    // would dropping into this column connect four for the player to move?
+    bool isWinningMove(int col) const
+    {
+        return hasFourInARow(_boards[_moves & 1] | cellMask(col, _height[col]));
+    }
+
+    // did the player who just moved connect four?
+    bool lastMoveWon() const
+    {
+        return _moves > 0 && hasFourInARow(_boards[(_moves - 1) & 1]);
+    }
+
+    static uint64_t cellMask(int col, int row) { return 1ULL << (col * STRIDE + row); }
+
+    // key of the same position with the columns in reverse order
+    static uint64_t mirrorKey(uint64_t key)
+    {
+        const uint64_t column = (1ULL << STRIDE) - 1;
+        uint64_t mirrored = 0;
+        for (int col = 0; col < WIDTH; col++) {
+            mirrored |= ((key >> (col * STRIDE)) & column) << ((WIDTH - 1 - col) * STRIDE);
+        }
+        return mirrored;
+    }
+
+    // four in a row through one stone, only the lines through that cell are looked at
+    static bool connectsFour(uint64_t board, uint64_t cell)
+    {
+        static const int SHIFTS[4] = {1, STRIDE, STRIDE + 1, STRIDE - 1};
+        for (int i = 0; i < 4; i++) {
+            // grow the run out from the cell three times each way, the spare row stops it wrapping
+            uint64_t run = cell;
+            for (int step = 0; step < 3; step++) {
+                run |= ((run << SHIFTS[i]) | (run >> SHIFTS[i])) & board;
+            }
+            if (std::popcount(run) >= 4) return true;
+        }
+        return false;
+    }
+
+    static bool hasFourInARow(uint64_t board)
+    {
+        static const int SHIFTS[4] = {1, STRIDE, STRIDE + 1, STRIDE - 1};
+        for (int i = 0; i < 4; i++) {
+            uint64_t t = board & (board >> SHIFTS[i]);
+            if (t & (t >> (2 * SHIFTS[i]))) return true;
+        }
+        return false;
+    }
+
+    // conversion to and from the row-major, top row first "0/1/2" strings the game uses
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+private:
+    uint64_t    _boards[2];
+    uint8_t     _height[WIDTH];
+    int         _moves;
+};
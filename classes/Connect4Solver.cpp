@@ -0,0 +1,224 @@
+#include "Connect4Solver.h"
+#include "Connect4AI.h"
+#include <bit>
+#include <climits>
+
+// Move ordering - center columns first, threats decide before that
+static const int COL_ORDER[Connect4Position::WIDTH] = {3, 2, 4, 1, 5, 0, 6};
+
+Connect4Solver::Connect4Solver()
+{
+    _nodes = 0;
+    _stopped = false;
+    _timed = false;
+    _stopFlag = nullptr;
+}
+
+void Connect4Solver::start(const Connect4Position &position, int timeBudgetMs)
+{
+    _position = position;
+    _nodes = 0;
+    _stopped = false;
+    _timed = (timeBudgetMs > 0);
+    _deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeBudgetMs);
+    _table.newSearch();
+}
+
+Connect4Solver::Outcome Connect4Solver::solve(const Connect4Position &position, int timeBudgetMs)
+{
+    start(position, timeBudgetMs);
+    return solveCurrent();
+}
+
+int Connect4Solver::bestMove(const Connect4Position &position, int timeBudgetMs, Outcome &outcome)
+{
+    start(position, timeBudgetMs);
+    outcome = solveCurrent();
+    if (outcome == OUTCOME_UNKNOWN || _position.lastMoveWon() || _position.isFull()) {
+        return -1;
+    }
+
+    uint64_t mask = _position.mask();
+    uint64_t mine = _position.board(_position.currentPlayer());
+    uint64_t playable = Connect4AI::playableCells(mask);
+    uint64_t wins = Connect4AI::winningCells(mine, mask) & playable;
+    if (wins) {
+        return std::countr_zero(wins) / Connect4Position::STRIDE;
+    }
+
+    // a lost position has nothing to keep, any column will do
+    uint64_t theirWins = Connect4AI::winningCells(mine ^ mask, mask);
+    uint64_t forced = theirWins & playable;
+    uint64_t candidates = (forced ? forced : playable) & ~(theirWins >> 1);
+    if (outcome == OUTCOME_LOSS || !candidates) {
+        candidates = forced ? forced : playable;
+    }
+
+    int order[Connect4Position::WIDTH];
+    int count = orderMoves(candidates, -1, order);
+    for (int i = 0; i < count; i++) {
+        int col = order[i];
+        // null window: does this column score at least the value of the position?
+        _position.play(col);
+        int score = -negamax(-outcome, -outcome + 1);
+        _position.undo(col);
+        if (_stopped) break;
+        if (score >= outcome) {
+            return col;
+        }
+    }
+    outcome = OUTCOME_UNKNOWN;
+    return -1;
+}
+
+//
+// bisection on the value with null windows: each search only has to tell
+// whether the value is above the middle of what is still possible
+//
+Connect4Solver::Outcome Connect4Solver::solveCurrent()
+{
+    if (_position.lastMoveWon()) {
+        return OUTCOME_LOSS;
+    }
+    if (_position.isFull()) {
+        return OUTCOME_DRAW;
+    }
+
+    int low = OUTCOME_LOSS;
+    int high = OUTCOME_WIN;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        int score = negamax(middle, middle + 1);
+        if (_stopped) {
+            return OUTCOME_UNKNOWN;
+        }
+        if (score > middle) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return (Outcome)low;
+}
+
+bool Connect4Solver::shouldStop()
+{
+    // only look at the clock and the stop flag every thousand nodes or so
+    if ((_nodes & 1023) == 0 && !_stopped) {
+        if (_stopFlag && _stopFlag->load(std::memory_order_relaxed)) {
+            _stopped = true;
+        } else if (_timed && std::chrono::steady_clock::now() >= _deadline) {
+            _stopped = true;
+        }
+    }
+    return _stopped;
+}
+
+//
+// columns best first into order[], returns how many: the table move, then the ones
+// that leave the most cells to win on, ties going to the centre
+//
+int Connect4Solver::orderMoves(uint64_t candidates, int ttCol, int *order) const
+{
+    uint64_t mask = _position.mask();
+    uint64_t mine = _position.board(_position.currentPlayer());
+
+    int keys[Connect4Position::WIDTH];
+    int count = 0;
+    for (int col : COL_ORDER) {
+        if (!_position.canPlay(col)) continue;
+        uint64_t cell = candidates & Connect4Position::cellMask(col, _position.height(col));
+        if (!cell) continue;
+
+        int key = (col == ttCol) ? INT_MAX : std::popcount(Connect4AI::winningCells(mine | cell, mask | cell));
+
+        int i = count++;
+        while (i > 0 && keys[i - 1] < key) {
+            keys[i] = keys[i - 1];
+            order[i] = order[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        order[i] = col;
+    }
+    return count;
+}
+
+//
+// fail-hard negamax on -1 (loss), 0 (draw) and 1 (win), played out to the end of the game
+// the table's depth is the number of empty cells, so bigger subtrees are kept first
+//
+int Connect4Solver::negamax(int alpha, int beta)
+{
+    _nodes++;
+    if (shouldStop()) {
+        return 0; // result is thrown away
+    }
+
+    if (_position.isFull()) {
+        return 0; // Draw
+    }
+
+    uint64_t mask = _position.mask();
+    uint64_t mine = _position.board(_position.currentPlayer());
+    uint64_t playable = Connect4AI::playableCells(mask);
+
+    // Take an immediate win before searching anything else
+    if (Connect4AI::winningCells(mine, mask) & playable) {
+        return OUTCOME_WIN;
+    }
+
+    // A win the opponent threatens has to be blocked, two of them can't be,
+    // and playing right under one of their winning cells hands it to them
+    uint64_t theirWins = Connect4AI::winningCells(mine ^ mask, mask);
+    uint64_t forced = theirWins & playable;
+    if (forced & (forced - 1)) {
+        return OUTCOME_LOSS;
+    }
+    uint64_t candidates = (forced ? forced : playable) & ~(theirWins >> 1);
+    if (!candidates) {
+        return OUTCOME_LOSS;
+    }
+
+    // with two cells left and neither side winning on the next move, nobody can win
+    if (_position.moves() >= Connect4Position::NUM_CELLS - 2) {
+        return OUTCOME_DRAW;
+    }
+
+    uint64_t key = _position.key();
+    int ttMove = -1;
+    TranspositionTable::Entry entry;
+    if (_table.probe(key, entry)) {
+        ttMove = entry.move;
+        if (entry.bound == TranspositionTable::BOUND_EXACT) return entry.score;
+        if (entry.bound == TranspositionTable::BOUND_LOWER && entry.score >= beta) return entry.score;
+        if (entry.bound == TranspositionTable::BOUND_UPPER && entry.score <= alpha) return entry.score;
+    }
+
+    int order[Connect4Position::WIDTH];
+    int count = orderMoves(candidates, ttMove, order);
+    int empties = Connect4Position::NUM_CELLS - _position.moves();
+    int alphaOrig = alpha;
+    int bestCol = -1;
+
+    for (int i = 0; i < count; i++) {
+        int col = order[i];
+        _position.play(col);
+        int score = -negamax(-beta, -alpha);
+        _position.undo(col);
+        if (_stopped) return 0;
+
+        if (score >= beta) {
+            _table.store(key, empties, TranspositionTable::BOUND_LOWER, score, col);
+            return score;
+        }
+        if (score > alpha) {
+            alpha = score;
+            bestCol = col;
+        }
+    }
+
+    TranspositionTable::Bound bound = (alpha > alphaOrig) ? TranspositionTable::BOUND_EXACT : TranspositionTable::BOUND_UPPER;
+    _table.store(key, empties, bound, alpha, bestCol);
+    return alpha;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include "Connect4Position.h"
+#include "TranspositionTable.h"
+#include <cstdint>
+#include <chrono>
+#include <atomic>
+
+//
+// exact win/draw/loss solver for connect 4
+// unlike Connect4AI it never stops at a depth: every line is played out to the end,
+// so a result it returns is the game-theoretic value of the position
+//
+// the search only ever asks yes/no questions ("is it a win?", "is it at least a draw?")
+// with null windows, which is where alpha-beta prunes the most; a three valued score
+// needs at most two of them
+//
+// positions are pruned before they are searched: an immediate win ends the search,
+// a threat the opponent can play next has to be blocked, and moves right under one of
+// the opponent's winning cells are never tried
+//
+class Connect4Solver
+{
+public:
+    // result for the player to move
+    enum Outcome : int8_t {
+        OUTCOME_LOSS = -1,
+        OUTCOME_DRAW = 0,
+        OUTCOME_WIN = 1,
+        OUTCOME_UNKNOWN = 2     // the budget ran out first
+    };
+
+    Connect4Solver();
+
+    // value of the position, OUTCOME_UNKNOWN if it couldn't be proved in timeBudgetMs (0 means no limit)
+    Outcome     solve(const Connect4Position &position, int timeBudgetMs);
+    // a column that keeps the value of the position, -1 if the game is over or the budget ran out
+    int         bestMove(const Connect4Position &position, int timeBudgetMs, Outcome &outcome);
+
+    // nodes searched during the last call
+    uint64_t    nodes() const { return _nodes; }
+
+    // optional flag another thread can set to abandon the search
+    void        setStopFlag(const std::atomic<bool> *flag) { _stopFlag = flag; }
+
+    // transposition table budget, proved results stay valid between moves
+    void        setTableSize(size_t megabytes) { _table.resize(megabytes); }
+    void        clearTable() { _table.clear(); }
+
+private:
+    void        start(const Connect4Position &position, int timeBudgetMs);
+    Outcome     solveCurrent();
+    int         negamax(int alpha, int beta);
+    int         orderMoves(uint64_t candidates, int ttCol, int *order) const;
+    bool        shouldStop();
+
+    Connect4Position    _position;
+    TranspositionTable  _table;
+    uint64_t            _nodes;
+    bool                _stopped;
+    bool                _timed;
+    std::chrono::steady_clock::time_point _deadline;
+    const std::atomic<bool> *_stopFlag;
+};
@@ -14,6 +14,8 @@ public:
 
     Entity() : _entityType(EntityNone), _parent(nullptr), _retainCount(0) {};
     Entity(EntityType type) : _entityType(type) {};
+    // entities are cleaned up through Entity pointers, the derived destructors have to run
+    virtual ~Entity() {}
 
     EntityType getEntityType() {return _entityType; }
     
@@ -22,11 +24,14 @@ public:
     // get the parent
     Entity *getParent() { return _parent; }
 
+    // end the entity, entities that don't come from new hand their memory back their own way
+    virtual void destroy() { delete this; }
+
     // final cleanup of the entity
     void removeFromParentAndCleanup(bool cleanup) {
         _parent = nullptr; 
         if (cleanup) {
-            delete this; 
+            destroy();
         }
     }
     // release the sprite from the list being drawn if count has reached zero
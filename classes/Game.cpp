@@ -1,8 +1,8 @@
 #include "Game.h"
 #include "Bit.h"
 #include "BitHolder.h"
-#include "Turn.h"
 #include "../Application.h"
+#include <cmath>
 
 Game::Game()
 {
@@ -15,6 +15,10 @@ Game::Game()
 	_gameOptions.rowY = 0;
 	_gameOptions.score = 0;
 	_gameOptions.AIDepthSearches = 0;
+	_gameOptions.AIMAXDepth = 64;
+	_gameOptions.AITimeBudgetMs = 500;
+	_gameOptions.AITableSizeMB = 64;
+	_gameOptions.AIThreads = std::max(1, (int)std::thread::hardware_concurrency());
 	_gameOptions.AIvsAI = false;
 
 	_table = nullptr;
@@ -28,19 +32,17 @@ Game::Game()
 	_dragStartPos = ImVec2(0, 0);
 	_dragOffset = ImVec2(0, 0);
 	_oldPos = ImVec2(0, 0);
+	_aiCancel = false;
+	_searchCount = 0;
+	_replaying = false;
+	_stateDirty = true;
 }
 
+// games with a background AI cancel it in their own destructors, while everything the
+// search uses is still alive; by the time this runs it is all gone
 Game::~Game()
 {
-	for (auto &_turn : _turns)
-	{
-		delete _turn;
-	}
-	_turns.clear();
-	for (auto &_player : _players)
-	{
-		delete _player;
-	}
+	// the pools end any players and pieces still around
 	_players.clear();
 
 	_gameOptions.score = 0;
@@ -53,9 +55,10 @@ Game::~Game()
 void Game::setNumberOfPlayers(unsigned int n)
 {
 	_players.clear();
+	_playerPool.clear();
 	for (unsigned int i = 1; i <= n; i++)
 	{
-		Player *player = Player::initWithGame(this);
+		Player *player = _playerPool.create(this);
 		//		player->setName( std::format( "Player-{}", i ) );
 		player->setName("Player");
 		player->setPlayerNumber(i - 1); // player numbers are zero-based
@@ -65,10 +68,6 @@ void Game::setNumberOfPlayers(unsigned int n)
 
 	_gameOptions.gameNumber = 0;
 	_gameOptions.numberOfPlayers = n;
-
-	Turn *turn = Turn::initStartOfGame(this);
-	_turns.clear();
-	_turns.push_back(turn);
 }
 
 void Game::setAIPlayer(unsigned int playerNumber)
@@ -80,24 +79,86 @@ void Game::setAIPlayer(unsigned int playerNumber)
 
 void Game::startGame()
 {
+	// the usual starting position is left out of the record
 	std::string startState = stateString();
-	Turn *turn = _turns.at(0);
-	turn->_boardState = startState;
-	turn->_gameNumber = _gameOptions.gameNumber;
+	_record.reset(startState == initialStateString() ? "" : startState);
 	_gameOptions.currentTurnNo = 0;
 }
 
 void Game::endTurn()
 {
 	_gameOptions.currentTurnNo++;
-	std::string startState = stateString();
-	Turn *turn = new Turn;
-	turn->_boardState = stateString();
-	turn->_date = (int)_gameOptions.currentTurnNo;
-	turn->_score = _gameOptions.score;
-	turn->_gameNumber = _gameOptions.gameNumber;
-	_turns.push_back(turn);
-	ClassGame::EndOfTurn();
+	// a dragged piece is already where it landed, so syncGrid may find nothing to change
+	invalidateStateString();
+	if (!_replaying)
+	{
+		ClassGame::EndOfTurn();
+	}
+}
+
+const std::string &Game::stateString()
+{
+	if (_stateDirty)
+	{
+		_stateString = buildStateString();
+		_stateDirty = false;
+	}
+	return _stateString;
+}
+
+Bit *Game::newBit()
+{
+	Bit *bit = _bitPool.create();
+	bit->setPool(&_bitPool);
+	return bit;
+}
+
+void Game::releaseBits()
+{
+	Grid *grid = getGrid();
+	if (grid)
+	{
+		grid->forEachSquare([](ChessSquare *square, int x, int y) {
+			square->forgetBit();
+		});
+	}
+	_dragBit = nullptr;
+	_dropTarget = nullptr;
+	_oldHolder = nullptr;
+	_bitPool.clear();
+	invalidateStateString();
+}
+
+bool Game::replay(const GameRecord &record, int moves)
+{
+	cancelAI();
+	// the record passed in may be our own, which is rebuilt as the moves are played
+	GameRecord source = record;
+	std::string startState = source.initialState().empty() ? initialStateString() : source.initialState();
+
+	_gameOptions.currentTurnNo = 0;
+	setStateString(startState);
+	_record.reset(source.initialState());
+
+	bool ok = true;
+	_replaying = true;
+	source.forEachMove([&](int move) {
+		if (ok)
+		{
+			ok = replayMove(move);
+		}
+	}, moves);
+	_replaying = false;
+	return ok;
+}
+
+std::string Game::stateAtTurn(int turn)
+{
+	GameRecord current = _record;
+	replay(current, turn);
+	std::string state = stateString();
+	replay(current);
+	return state;
 }
 
 //
@@ -242,8 +303,46 @@ bool Game::gameHasAI()
 	return false;
 }
 
+//
+// the AI searches on a worker thread so the frame loop keeps running while it thinks
+// this is called every frame while it's the AI's turn: the first call starts the search,
+// later calls check on it and play the move on the main thread once it has finished
+//
 void Game::updateAI()
 {
+	if (!_aiJob.valid())
+	{
+		if (!prepareAIMove())
+		{
+			return;
+		}
+		_aiCancel = false;
+		_aiJob = std::async(std::launch::async, [this]() { return searchAIMove(_aiCancel); });
+		return;
+	}
+
+	if (_aiJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return;
+	}
+
+	// the worker is done with _searchStats once its result is in
+	int move = _aiJob.get();
+	if (move >= 0)
+	{
+		publishSearchStats();
+		applyAIMove(move);
+	}
+}
+
+void Game::cancelAI()
+{
+	if (_aiJob.valid())
+	{
+		_aiCancel = true;
+		_aiJob.wait();
+		_aiJob = std::future<int>();
+	}
 }
 
 void Game::mouseDown(ImVec2 &location, Entity *entity)
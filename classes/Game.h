@@ -18,10 +18,12 @@
 #endif
 
 #include "Player.h"
-#include "Turn.h"
+#include "GameRecord.h"
+#include "SearchStats.h"
 #include "Bit.h"
 #include "BitHolder.h"
 #include "Grid.h"
+#include "ObjectPool.h"
 
 
 const int AI_PLAYER = 1;
@@ -40,7 +42,10 @@ struct GameOptions
 	unsigned int currentTurnNo;
 	int score;
 	int AIDepthSearches;
-	int AIMAXDepth;
+	int AIMAXDepth;			// deepest iteration the AI will search to
+	int AITimeBudgetMs;		// time the AI may spend on a move, 0 for no limit
+	int AITableSizeMB;		// transposition table budget for games that search
+	int AIThreads;			// search threads for games with a parallel search
 	bool AIvsAI;
 };
 
@@ -48,7 +53,8 @@ class Game
 {
 public:
 	Game();
-	~Game();
+	// games are deleted through Game pointers, the derived destructors have to run
+	virtual ~Game();
 
 	void startGame();
 
@@ -94,13 +100,30 @@ public:
 
 	virtual void stopGame() = 0;
 	virtual bool gameHasAI();
+	// starts the AI's search on a worker thread, later calls play the move once it is ready
 	virtual void updateAI();
+	// stop any running AI search and wait for the worker, call before resetting the game and
+	// first thing in the destructor of every game that searches
+	void cancelAI();
+	bool isAIThinking() const { return _aiJob.valid(); }
+	// what the search behind the AI's last move did, and how many moves the AI has searched
+	const SearchStats &lastSearchStats() const { return _lastSearchStats; }
+	unsigned int searchCount() const { return _searchCount; }
 	virtual void pieceTaken(Bit *bit){};
 
 	virtual std::string initialStateString() = 0;
-	virtual std::string stateString() = 0;
+	// the board as a string, rebuilt only after the pieces on the grid change
+	const std::string &stateString();
 	virtual void setStateString(const std::string &s) = 0;
 
+	// every move since startGame, states in between are played again rather than stored
+	const GameRecord &record() const { return _record; }
+	// set the game up from a record, playing its first moves (all of them if negative)
+	// false if the game rejects one of them, the moves before it stay played
+	bool replay(const GameRecord &record, int moves = -1);
+	// the state after the given number of moves, found by replaying the record
+	std::string stateAtTurn(int turn);
+
 	void setNumberOfPlayers(unsigned int playerCount);
 	void setAIPlayer(unsigned int playerNumber);
 	virtual int getAIDepathSearches() { return _gameOptions.AIDepthSearches; };
@@ -131,13 +154,39 @@ public:
 	Player *_winner;
 
 	std::vector<Player *> _players;
-	std::vector<Turn *> _turns;
 
 	std::string _lastMove;
 
 	GameOptions _gameOptions;
 
 protected:
+	// background AI, used by the default updateAI
+	// prepareAIMove runs on the main thread and should copy whatever the search needs,
+	// searchAIMove runs on the worker and may only touch that copy (and should give up when cancel is set),
+	// applyAIMove is back on the main thread and plays the returned move
+	virtual bool prepareAIMove() { return false; }
+	virtual int searchAIMove(const std::atomic<bool> &cancel) { return -1; }
+	virtual void applyAIMove(int move) {}
+	// searchAIMove fills this in on the worker, it is handed over once the move is ready
+	SearchStats _searchStats;
+	// hand _searchStats to the application, just before the move it chose is played
+	void publishSearchStats() { _lastSearchStats = _searchStats; _searchCount++; }
+
+	// games call recordMove with the number of each move they play, before ending the turn,
+	// and replayMove plays such a number again; both go through the usual move code
+	void recordMove(int move) { _record.append(move); }
+	virtual bool replayMove(int move) { return false; }
+
+	// the board as a string, for stateString to cache
+	virtual std::string buildStateString() = 0;
+	// pieces were placed, removed or flipped, stateString has to be rebuilt
+	void invalidateStateString() { _stateDirty = true; }
+
+	// a new piece from this game's pool
+	Bit *newBit();
+	// take every piece off the grid and end them all at once, for stopGame
+	void releaseBits();
+
 	void mouseDown(ImVec2 &location, Entity *bit);
 	void mouseMoved(ImVec2 &location, Entity *bit);
 	void mouseUp(ImVec2 &location, Entity *bit);
@@ -151,4 +200,19 @@ protected:
 	BitHolder *_dropTarget;
 	BitHolder *_oldHolder;
 	bool _dragMoved;
+
+	// players and pieces live here for as long as the game does
+	ObjectPool<Player> _playerPool;
+	ObjectPool<Bit> _bitPool;
+
+	GameRecord _record;
+	std::string _stateString;
+	bool _stateDirty;
+	// replaying a record, turns end without telling the application
+	bool _replaying;
+
+	std::future<int> _aiJob;
+	std::atomic<bool> _aiCancel;
+	SearchStats _lastSearchStats;
+	unsigned int _searchCount;
 };
@@ -0,0 +1,138 @@
+#include "GameRecord.h"
+#include <cstdio>
+
+GameRecord::GameRecord()
+{
+    _count = 0;
+}
+
+void GameRecord::reset(const std::string &initialState)
+{
+    _initialState = initialState;
+    _moves.clear();
+    _count = 0;
+}
+
+void GameRecord::append(int move)
+{
+    if (move < PASS) {
+        return;
+    }
+    writeVarint(_moves, (uint64_t)(move + 1));
+    _count++;
+}
+
+std::vector<int> GameRecord::moves() const
+{
+    std::vector<int> result;
+    result.reserve(_count);
+    forEachMove([&](int move) { result.push_back(move); });
+    return result;
+}
+
+void GameRecord::serialize(std::vector<uint8_t> &out) const
+{
+    out.push_back('G');
+    out.push_back('R');
+    out.push_back((uint8_t)VERSION);
+    writeVarint(out, _initialState.size());
+    out.insert(out.end(), _initialState.begin(), _initialState.end());
+    writeVarint(out, (uint64_t)_count);
+    writeVarint(out, _moves.size());
+    out.insert(out.end(), _moves.begin(), _moves.end());
+}
+
+bool GameRecord::deserialize(const uint8_t *&data, const uint8_t *end)
+{
+    const uint8_t *p = data;
+    if (end - p < 3 || p[0] != 'G' || p[1] != 'R' || p[2] != VERSION) {
+        return false;
+    }
+    p += 3;
+
+    uint64_t stateLength = readVarint(p, end);
+    if ((uint64_t)(end - p) < stateLength) {
+        return false;
+    }
+    std::string state((const char *)p, (size_t)stateLength);
+    p += stateLength;
+
+    uint64_t count = readVarint(p, end);
+    uint64_t byteCount = readVarint(p, end);
+    // every move takes at least a byte
+    if ((uint64_t)(end - p) < byteCount || count > byteCount) {
+        return false;
+    }
+
+    _initialState = std::move(state);
+    _moves.assign(p, p + byteCount);
+    _count = (int)count;
+    data = p + byteCount;
+    return true;
+}
+
+bool GameRecord::save(const std::string &path, bool append) const
+{
+    std::vector<uint8_t> data;
+    serialize(data);
+
+    FILE *file = std::fopen(path.c_str(), append ? "ab" : "wb");
+    if (!file) {
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return std::fclose(file) == 0 && ok;
+}
+
+bool GameRecord::load(const std::string &path)
+{
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        return false;
+    }
+    const uint8_t *p = data.data();
+    return deserialize(p, p + data.size());
+}
+
+bool GameRecord::loadAll(const std::string &path, std::vector<GameRecord> &records)
+{
+    std::vector<uint8_t> data;
+    if (!readFile(path, data)) {
+        return false;
+    }
+    const uint8_t *p = data.data();
+    const uint8_t *end = p + data.size();
+    while (p < end) {
+        GameRecord record;
+        if (!record.deserialize(p, end)) {
+            return false;
+        }
+        records.push_back(std::move(record));
+    }
+    return true;
+}
+
+void GameRecord::writeVarint(std::vector<uint8_t> &out, uint64_t value)
+{
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        out.push_back(value ? (byte | 0x80) : byte);
+    } while (value);
+}
+
+bool GameRecord::readFile(const std::string &path, std::vector<uint8_t> &data)
+{
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        return false;
+    }
+    uint8_t buffer[4096];
+    size_t read;
+    while ((read = std::fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        data.insert(data.end(), buffer, buffer + read);
+    }
+    bool ok = !std::ferror(file);
+    std::fclose(file);
+    return ok;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// compact record of one game: the state it started from and the moves played since
+//
+// a move is whatever small number the game uses to name it (a column, a square, an
+// index into its move list), stored as move + 1 in LEB128, 7 bits per byte, so PASS
+// fits too and nearly every move of the games here takes a single byte; the states in
+// between are never stored, Game::replay plays the moves again to get them back
+//
+// serialized, a record is
+//
+//   "GR" version   initial state length, initial state   move count   byte count, moves
+//
+// with every number in the same LEB128; records are self delimiting, so an archive of
+// many games is just records written one after the other
+//
+class GameRecord
+{
+public:
+    static constexpr uint8_t VERSION = 1;
+    static constexpr int PASS = -1;
+
+    GameRecord();
+
+    // start over from a state, an empty string meaning the game's own initial state
+    void        reset(const std::string &initialState);
+    // add the next move, PASS or greater
+    void        append(int move);
+
+    const std::string &initialState() const { return _initialState; }
+    int         size() const { return _count; }
+    bool        empty() const { return _count == 0; }
+    // bytes the moves take up
+    size_t      byteSize() const { return _moves.size(); }
+
+    // call f(move) for the first limit moves, all of them if limit is negative
+    template <typename F>
+    void forEachMove(F f, int limit = -1) const
+    {
+        const uint8_t *p = _moves.data();
+        const uint8_t *end = p + _moves.size();
+        for (int i = 0; i < _count && i != limit && p < end; i++) {
+            f((int)readVarint(p, end) - 1);
+        }
+    }
+    std::vector<int> moves() const;
+
+    // append the record to out
+    void        serialize(std::vector<uint8_t> &out) const;
+    // read one record starting at data and move data past it, false if it isn't one
+    bool        deserialize(const uint8_t *&data, const uint8_t *end);
+
+    // write the record to a file, or add it to the end of an archive
+    bool        save(const std::string &path, bool append = false) const;
+    // read the first record of a file
+    bool        load(const std::string &path);
+    // read every record of an archive, false if the file can't be read or is damaged
+    static bool loadAll(const std::string &path, std::vector<GameRecord> &records);
+
+private:
+    static void     writeVarint(std::vector<uint8_t> &out, uint64_t value);
+    // a truncated number reads as far as it goes, deserialize checks for that separately
+    static uint64_t readVarint(const uint8_t *&p, const uint8_t *end)
+    {
+        uint64_t value = 0;
+        int shift = 0;
+        while (p < end && shift < 64) {
+            uint8_t byte = *p++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            shift += 7;
+            if (!(byte & 0x80)) break;
+        }
+        return value;
+    }
+    static bool     readFile(const std::string &path, std::vector<uint8_t> &data);
+
+    std::string             _initialState;
+    std::vector<uint8_t>    _moves;
+    int                     _count;
+};
@@ -1,35 +1,15 @@
 #include "Grid.h"
+#include <algorithm>
 
 Grid::Grid(int width, int height) : _width(width), _height(height)
 {
-    // Initialize 2D vectors
-    _squares.resize(height);
-    _enabled.resize(height);
-
-    for (int y = 0; y < height; y++) {
-        _squares[y].resize(width);
-        _enabled[y].resize(width);
-
-        for (int x = 0; x < width; x++) {
-            _squares[y][x] = new ChessSquare();
-            _enabled[y][x] = true; // All squares enabled by default
-        }
-    }
+    _squares.reset(new ChessSquare[width * height]);
+    // All squares enabled by default
+    _enabled.assign((width * height + 63) / 64, ~0ull);
 }
 
 Grid::~Grid()
 {
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            delete _squares[y][x];
-        }
-    }
-}
-
-ChessSquare* Grid::getSquare(int x, int y)
-{
-    if (!isValid(x, y)) return nullptr;
-    return _squares[y][x];
 }
 
 ChessSquare* Grid::getSquareByIndex(int index)
@@ -39,21 +19,16 @@ ChessSquare* Grid::getSquareByIndex(int index)
     return getSquare(x, y);
 }
 
-bool Grid::isValid(int x, int y) const
-{
-    return x >= 0 && x < _width && y >= 0 && y < _height;
-}
-
-bool Grid::isEnabled(int x, int y) const
-{
-    if (!isValid(x, y)) return false;
-    return _enabled[y][x];
-}
-
 void Grid::setEnabled(int x, int y, bool enabled)
 {
     if (isValid(x, y)) {
-        _enabled[y][x] = enabled;
+        int index = getIndex(x, y);
+        uint64_t bit = 1ull << (index & 63);
+        if (enabled) {
+            _enabled[index >> 6] |= bit;
+        } else {
+            _enabled[index >> 6] &= ~bit;
+        }
     }
 }
 
@@ -149,27 +124,6 @@ bool Grid::areConnected(int fromX, int fromY, int toX, int toY)
     return false;
 }
 
-// Iterator support
-void Grid::forEachSquare(std::function<void(ChessSquare*, int x, int y)> func)
-{
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            func(_squares[y][x], x, y);
-        }
-    }
-}
-
-void Grid::forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func)
-{
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                func(_squares[y][x], x, y);
-            }
-        }
-    }
-}
-
 // Initialize squares
 void Grid::initializeSquares(float squareSize, const char* spriteName)
 {
@@ -184,7 +138,7 @@ void Grid::initializeSquare(int x, int y, float squareSize, const char* spriteNa
 {
     if (isValid(x, y)) {
         ImVec2 position(squareSize * x + squareSize/2, squareSize * y + squareSize/2);
-        _squares[y][x]->initHolder(position, spriteName, x, y);
+        _squares[getIndex(x, y)].initHolder(position, spriteName, x, y);
     }
 }
 
@@ -192,16 +146,15 @@ void Grid::initializeSquare(int x, int y, float squareSize, const char* spriteNa
 std::string Grid::getStateString() const
 {
     std::string state;
-
-    for (int y = 0; y < _height; y++) {
-        for (int x = 0; x < _width; x++) {
-            if (_enabled[y][x]) {
-                Bit* bit = _squares[y][x]->bit();
-                if (bit) {
-                    state += std::to_string(bit->gameTag());
-                } else {
-                    state += '0';
-                }
+    state.reserve(_width * _height);
+
+    for (int index = 0; index < _width * _height; index++) {
+        if (enabledAt(index)) {
+            Bit* bit = _squares[index].bit();
+            if (bit) {
+                state += std::to_string(bit->gameTag());
+            } else {
+                state += '0';
             }
         }
     }
@@ -215,11 +168,11 @@ void Grid::setStateString(const std::string& state)
 
     for (int y = 0; y < _height && index < state.length(); y++) {
         for (int x = 0; x < _width && index < state.length(); x++) {
-            if (_enabled[y][x]) {
+            if (enabledAt(getIndex(x, y))) {
                 char pieceChar = state[index++];
 
                 // Clear existing piece
-                _squares[y][x]->destroyBit();
+                _squares[getIndex(x, y)].destroyBit();
 
                 // This method just sets the state - games need to create their own pieces
                 // when loading from state string based on the piece type
@@ -3,7 +3,8 @@
 #include "ChessSquare.h"
 #include <vector>
 #include <unordered_map>
-#include <functional>
+#include <memory>
+#include <cstdint>
 #include <string>
 
 class Grid
@@ -13,10 +14,10 @@ public:
     ~Grid();
 
     // Basic access
-    ChessSquare* getSquare(int x, int y);
+    ChessSquare* getSquare(int x, int y) { return isValid(x, y) ? &_squares[getIndex(x, y)] : nullptr; }
     ChessSquare* getSquareByIndex(int index);
-    bool isValid(int x, int y) const;
-    bool isEnabled(int x, int y) const;
+    bool isValid(int x, int y) const { return x >= 0 && x < _width && y >= 0 && y < _height; }
+    bool isEnabled(int x, int y) const { return isValid(x, y) && enabledAt(getIndex(x, y)); }
     void setEnabled(int x, int y, bool enabled);
 
     // Grid properties
@@ -49,9 +50,31 @@ public:
     std::vector<ChessSquare*> getConnectedSquares(int x, int y);
     bool areConnected(int fromX, int fromY, int toX, int toY);
 
-    // Iterator support
-    void forEachSquare(std::function<void(ChessSquare*, int x, int y)> func);
-    void forEachEnabledSquare(std::function<void(ChessSquare*, int x, int y)> func);
+    // Iterator support, func(square, x, y) in row order
+    // templates rather than std::function so the loop and the callback inline together
+    template <typename F>
+    void forEachSquare(F&& func)
+    {
+        ChessSquare* square = _squares.get();
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++, square++) {
+                func(square, x, y);
+            }
+        }
+    }
+    template <typename F>
+    void forEachEnabledSquare(F&& func)
+    {
+        ChessSquare* square = _squares.get();
+        int index = 0;
+        for (int y = 0; y < _height; y++) {
+            for (int x = 0; x < _width; x++, square++, index++) {
+                if (enabledAt(index)) {
+                    func(square, x, y);
+                }
+            }
+        }
+    }
 
     // Initialize squares with positions and sprites
     void initializeSquares(float squareSize, const char* spriteName);
@@ -62,8 +85,11 @@ public:
     void setStateString(const std::string& state);
 
 private:
-    std::vector<std::vector<ChessSquare*>> _squares;
-    std::vector<std::vector<bool>> _enabled;
+    bool enabledAt(int index) const { return (_enabled[index >> 6] >> (index & 63)) & 1; }
+
+    // one block of squares in row order, and one bit per square for enabled
+    std::unique_ptr<ChessSquare[]> _squares;
+    std::vector<uint64_t> _enabled;
     std::unordered_map<int, std::vector<int>> _connections;
     int _width;
     int _height;
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//
+// read-only memory mapping of a whole file
+// the operating system pages the contents in as they are touched, so opening even
+// a large table is cheap and nothing is copied onto the heap
+//
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // map the file, replacing any earlier mapping; false if it can't be opened or is empty
+    bool            open(const std::string &path);
+    void            close();
+
+    bool            isOpen() const { return _data != nullptr; }
+    const uint8_t  *data() const { return _data; }
+    size_t          size() const { return _size; }
+
+private:
+    const uint8_t  *_data;
+    size_t          _size;
+#ifdef _WIN32
+    void           *_file;
+    void           *_mapping;
+#endif
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+//
+// pool of objects of one type, allocated CHUNK_SIZE at a time
+// a game creates its players and pieces here, freed slots are reused straight away and
+// clear() ends every object still alive in one pass while keeping the chunks, so
+// resetting a game again and again stops touching the heap after the first game
+//
+template <typename T>
+class ObjectPool
+{
+public:
+    static const int CHUNK_SIZE = 64;
+
+    ObjectPool() : _free(nullptr), _live(0) {}
+    ~ObjectPool()
+    {
+        clear();
+        for (Slot *chunk : _chunks) {
+            ::operator delete(chunk);
+        }
+    }
+
+    ObjectPool(const ObjectPool &) = delete;
+    ObjectPool &operator=(const ObjectPool &) = delete;
+
+    template <typename... Args>
+    T *create(Args &&...args)
+    {
+        if (!_free) {
+            addChunk();
+        }
+        Slot *slot = _free;
+        T *object = new (slot->storage) T(std::forward<Args>(args)...);
+        _free = slot->next;
+        slot->live = true;
+        _live++;
+        return object;
+    }
+
+    // end one object from this pool, its slot is the next one handed out
+    void destroy(T *object)
+    {
+        if (!object) return;
+        Slot *slot = reinterpret_cast<Slot *>(object);
+        object->~T();
+        slot->live = false;
+        slot->next = _free;
+        _free = slot;
+        _live--;
+    }
+
+    // end every object still alive, anything pointing at them is left dangling
+    void clear()
+    {
+        _free = nullptr;
+        for (size_t c = _chunks.size(); c-- > 0;) {
+            Slot *chunk = _chunks[c];
+            for (int i = CHUNK_SIZE; i-- > 0;) {
+                Slot &slot = chunk[i];
+                if (slot.live) {
+                    reinterpret_cast<T *>(slot.storage)->~T();
+                    slot.live = false;
+                }
+                slot.next = _free;
+                _free = &slot;
+            }
+        }
+        _live = 0;
+    }
+
+    size_t size() const { return _live; }
+    size_t capacity() const { return _chunks.size() * CHUNK_SIZE; }
+
+private:
+    // storage comes first so an object's address is its slot's
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        Slot   *next;
+        bool    live;
+    };
+
+    void addChunk()
+    {
+        Slot *chunk = static_cast<Slot *>(::operator new(sizeof(Slot) * CHUNK_SIZE));
+        for (int i = CHUNK_SIZE; i-- > 0;) {
+            chunk[i].live = false;
+            chunk[i].next = _free;
+            _free = &chunk[i];
+        }
+        _chunks.push_back(chunk);
+    }
+
+    std::vector<Slot *> _chunks;
+    Slot               *_free;
+    size_t              _live;
+};
@@ -1,19 +1,16 @@
 #include "Othello.h"
-#include <iostream>
-
-// Define the 8 directions: N, NE, E, SE, S, SW, W, NW
-const int Othello::DIRECTIONS[8][2] = {
-    {0, -1}, {1, -1}, {1, 0}, {1, 1},
-    {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}
-};
 
 Othello::Othello() : Game() {
     _grid = new Grid(8, 8);
-    _consecutivePasses = 0;
     _showingHints = false;
+    _gameOver = false;
+    _searchMaxDepth = 0;
+    _searchTimeBudgetMs = 0;
 }
 
 Othello::~Othello() {
+    // the worker may still be searching with our AI
+    cancelAI();
     delete _grid;
 }
 
@@ -24,21 +21,10 @@ void Othello::setUpBoard() {
 
     _grid->initializeSquares(80, "boardsquare.png");
 
-    // Set up initial four pieces in the center
-    Player* blackPlayer = getPlayerAt(BLACK_PLAYER);
-    Player* whitePlayer = getPlayerAt(WHITE_PLAYER);
-
     // Standard Othello starting position
-    auto placePiece = [&](int x, int y, Player* player) {
-        Bit* piece = createPiece(player);
-        piece->setPosition(_grid->getSquare(x, y)->getPosition());
-        _grid->getSquare(x, y)->setBit(piece);
-    };
-
-    placePiece(3, 3, whitePlayer);  // White at (3,3)
-    placePiece(4, 4, whitePlayer);  // White at (4,4)
-    placePiece(4, 3, blackPlayer);  // Black at (4,3)
-    placePiece(3, 4, blackPlayer);  // Black at (3,4)
+    _board.reset();
+    _gameOver = false;
+    syncGrid();
 
     if (gameHasAI()) {
         setAIPlayer(AI_PLAYER);
@@ -48,43 +34,69 @@ void Othello::setUpBoard() {
 }
 
 Bit* Othello::createPiece(Player* player) {
-    Bit* bit = new Bit();
-    bit->LoadTextureFromFile(player == getPlayerAt(BLACK_PLAYER) ? "o.png" : "x.png");
-    bit->setOwner(player);
+    Bit* bit = newBit();
+    setPieceOwner(bit, player);
     return bit;
 }
 
+void Othello::setPieceOwner(Bit* bit, Player* player) {
+    bool black = (player == getPlayerAt(BLACK_PLAYER));
+    bit->LoadTextureFromFile(black ? "o.png" : "x.png");
+    bit->setOwner(player);
+    bit->setGameTag(black ? 1 : 2);
+}
+
+//
+// mirror _board into the grid, only touching squares whose disc changed
+// flipped discs keep their Bit and just change hands
+//
+void Othello::syncGrid() {
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        uint64_t mask = OthelloBoard::squareMask(y * OthelloBoard::SIZE + x);
+        int want = 0;
+        if (_board.board(BLACK_PLAYER) & mask) want = 1;
+        else if (_board.board(WHITE_PLAYER) & mask) want = 2;
+
+        Bit* bit = square->bit();
+        if ((bit ? bit->gameTag() : 0) == want) return;
+        invalidateStateString();
+
+        if (want == 0) {
+            square->destroyBit();
+        } else if (bit) {
+            setPieceOwner(bit, getPlayerAt(want - 1));
+        } else {
+            Bit* piece = createPiece(getPlayerAt(want - 1));
+            piece->setPosition(square->getPosition());
+            square->setBit(piece);
+        }
+    });
+}
+
 bool Othello::actionForEmptyHolder(BitHolder &holder) {
     if (holder.bit()) return false;
 
     ChessSquare* square = static_cast<ChessSquare*>(&holder);
-    int x = square->getColumn();
-    int y = square->getRow();
-    Player* currentPlayer = getCurrentPlayer();
-
-    if (!isValidMove(x, y, currentPlayer)) return false;
-
-    // Place the piece
-    Bit* newPiece = createPiece(currentPlayer);
-    newPiece->setPosition(holder.getPosition());
-    holder.setBit(newPiece);
-
-    // Flip all affected pieces
-    flipPieces(x, y, currentPlayer);
-    _consecutivePasses = 0;
-
-    // Check if next player has moves
-    Player* nextPlayer = getPlayerAt(1 - currentPlayer->playerNumber());
-    if (!hasValidMove(nextPlayer)) {
-        _consecutivePasses++;
-        if (hasValidMove(currentPlayer)) {
+    int index = square->getRow() * OthelloBoard::SIZE + square->getColumn();
+
+    if (!(_board.legalMoves() & OthelloBoard::squareMask(index))) return false;
+
+    // Place the piece and flip all affected pieces
+    _board.play(index);
+    recordMove(index);
+
+    // Check if next player has moves, the game can only end here
+    if (!_board.legalMoves()) {
+        if (_board.legalMovesFor(_board.currentPlayer() ^ 1)) {
             // Next player passes, current player continues
+            _board.pass();
+            syncGrid();
             return true;
-        } else {
-            _consecutivePasses = 2; // Game ends
         }
+        _gameOver = true;
     }
 
+    syncGrid();
     endTurn();
     return true;
 }
@@ -97,156 +109,25 @@ bool Othello::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst) {
     return false; // Pieces cannot be moved in Othello
 }
 
-bool Othello::isValidMove(int x, int y, Player* player) const {
-    if (!_grid->isValid(x, y) || _grid->getSquare(x, y)->bit()) return false;
-
-    // Check if placing a piece here would flip at least one opponent piece
-    for (int i = 0; i < 8; i++) {
-        if (checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player) > 0) {
-            return true;
-        }
-    }
-    return false;
-}
-
-int Othello::checkDirection(int x, int y, int dx, int dy, Player* player) const {
-    int count = 0;
-    int nx = x + dx;
-    int ny = y + dy;
-
-    if (!_grid->isValid(nx, ny)) return 0;
-
-    Bit* firstPiece = _grid->getSquare(nx, ny)->bit();
-    if (!firstPiece || firstPiece->getOwner() == player) return 0;
-
-    // Count opponent pieces in this direction
-    while (_grid->isValid(nx, ny)) {
-        Bit* piece = _grid->getSquare(nx, ny)->bit();
-        if (!piece) return 0;
-        if (piece->getOwner() == player) return count;
-        count++;
-        nx += dx;
-        ny += dy;
-    }
-    return 0;
-}
-
-void Othello::flipPieces(int x, int y, Player* player) {
-    for (int i = 0; i < 8; i++) {
-        int count = checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player);
-        if (count > 0) {
-            flipInDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], player, count);
-        }
-    }
-}
-
-void Othello::flipInDirection(int x, int y, int dx, int dy, Player* player, int count) {
-    int nx = x + dx;
-    int ny = y + dy;
-
-    for (int i = 0; i < count; i++) {
-        ChessSquare* square = _grid->getSquare(nx, ny);
-        if (square && square->bit()) {
-            square->destroyBit();
-            Bit* newPiece = createPiece(player);
-            newPiece->setPosition(square->getPosition());
-            square->setBit(newPiece);
-        }
-        nx += dx;
-        ny += dy;
-    }
-}
-
-bool Othello::hasValidMove(Player* player) const {
-    bool hasMove = false;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (!hasMove && isValidMove(x, y, player)) {
-            hasMove = true;
-        }
-    });
-    return hasMove;
-}
-
-std::vector<std::pair<int, int>> Othello::getValidMoves(Player* player) const {
-    std::vector<std::pair<int, int>> moves;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (isValidMove(x, y, player)) {
-            moves.push_back({x, y});
-        }
-    });
-    return moves;
-}
-
 Player* Othello::checkForWinner() {
-    // Game ends when neither player can move
-    if (_consecutivePasses >= 2 ||
-        (!hasValidMove(getPlayerAt(BLACK_PLAYER)) && !hasValidMove(getPlayerAt(WHITE_PLAYER)))) {
-
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-
-        if (blackCount > whiteCount) return getPlayerAt(BLACK_PLAYER);
-        if (whiteCount > blackCount) return getPlayerAt(WHITE_PLAYER);
-    }
-
-    // Check if board is full
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
-    });
-
-    if (boardFull) {
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-        if (blackCount > whiteCount) return getPlayerAt(BLACK_PLAYER);
-        if (whiteCount > blackCount) return getPlayerAt(WHITE_PLAYER);
-    }
+    // Game ends when neither player can move, which includes a full board
+    if (!_gameOver) return nullptr;
 
+    int blackCount = _board.count(BLACK_PLAYER);
+    int whiteCount = _board.count(WHITE_PLAYER);
+    if (blackCount > whiteCount) return getPlayerAt(BLACK_PLAYER);
+    if (whiteCount > blackCount) return getPlayerAt(WHITE_PLAYER);
     return nullptr;
 }
 
 bool Othello::checkForDraw() {
-    if (_consecutivePasses >= 2 ||
-        (!hasValidMove(getPlayerAt(BLACK_PLAYER)) && !hasValidMove(getPlayerAt(WHITE_PLAYER)))) {
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-        return blackCount == whiteCount;
-    }
-
-    bool boardFull = true;
-    _grid->forEachSquare([&boardFull](ChessSquare* square, int x, int y) {
-        if (!square->bit()) boardFull = false;
-    });
-
-    if (boardFull) {
-        int blackCount, whiteCount;
-        countPieces(blackCount, whiteCount);
-        return blackCount == whiteCount;
-    }
-    return false;
-}
-
-void Othello::countPieces(int &blackCount, int &whiteCount) const {
-    blackCount = 0;
-    whiteCount = 0;
-
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        Bit* piece = square->bit();
-        if (piece) {
-            if (piece->getOwner() == getPlayerAt(BLACK_PLAYER)) {
-                blackCount++;
-            } else {
-                whiteCount++;
-            }
-        }
-    });
+    return _gameOver && _board.count(BLACK_PLAYER) == _board.count(WHITE_PLAYER);
 }
 
 void Othello::stopGame() {
-    _grid->forEachSquare([](ChessSquare* square, int x, int y) {
-        square->destroyBit();
-    });
-    _consecutivePasses = 0;
+    releaseBits();
+    _board.reset();
+    _gameOver = false;
 }
 
 std::string Othello::initialStateString() {
@@ -258,73 +139,61 @@ std::string Othello::initialStateString() {
     return state;
 }
 
-std::string Othello::stateString() {
-    std::string state;
-    _grid->forEachSquare([&state, this](ChessSquare* square, int x, int y) {
-        Bit* bit = square->bit();
-        if (!bit) {
-            state += '0';
-        } else if (bit->getOwner() == getPlayerAt(BLACK_PLAYER)) {
-            state += '1';
-        } else {
-            state += '2';
-        }
-    });
-    return state;
+std::string Othello::buildStateString() {
+    return _board.stateString();
 }
 
 void Othello::setStateString(const std::string &s) {
-    if (s.length() != 64) return;
+    if (!_board.setStateString(s)) return;
 
-    int index = 0;
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        if (index < s.length()) {
-            char pieceType = s[index++];
-            square->destroyBit();
+    // passes never end a turn, so the turn number always tells who is to move
+    _board.setCurrentPlayer(_gameOptions.currentTurnNo & 1);
+    _gameOver = _board.isGameOver();
+    syncGrid();
+}
 
-            if (pieceType == '1') {
-                Bit* piece = createPiece(getPlayerAt(BLACK_PLAYER));
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            } else if (pieceType == '2') {
-                Bit* piece = createPiece(getPlayerAt(WHITE_PLAYER));
-                piece->setPosition(square->getPosition());
-                square->setBit(piece);
-            }
+bool Othello::prepareAIMove() {
+    // nothing to play, hand the turn straight over
+    if (!_board.legalMoves()) {
+        if (!_gameOver) {
+            _board.pass();
+            recordMove(GameRecord::PASS);
+            endTurn();
         }
-    });
+        return false;
+    }
+
+    _ai.setTableSize(_gameOptions.AITableSizeMB);
+    _searchBoard = _board;
+    _searchMaxDepth = getAIMAXDepth();
+    _searchTimeBudgetMs = _gameOptions.AITimeBudgetMs;
+    return true;
 }
 
-void Othello::updateAI() {
-    if (!gameHasAI()) return;
+// runs on the AI worker thread
+int Othello::searchAIMove(const std::atomic<bool> &cancel) {
+    int bestScore = 0;
+    _ai.setStopFlag(&cancel);
+    int square = _ai.search(_searchBoard, _searchMaxDepth, _searchTimeBudgetMs, bestScore);
+    _searchStats = _ai.stats();
+    return square;
+}
 
-    Player* aiPlayer = getCurrentPlayer();
-    std::vector<std::pair<int, int>> validMoves = getValidMoves(aiPlayer);
+void Othello::applyAIMove(int move) {
+    actionForEmptyHolder(*_grid->getSquare(move % OthelloBoard::SIZE, move / OthelloBoard::SIZE));
+}
 
-    if (validMoves.empty()) {
-        _consecutivePasses++;
+// moves are recorded as the square index, with a pass when the player had nothing to play
+bool Othello::replayMove(int move) {
+    if (move == GameRecord::PASS) {
+        if (_board.legalMoves() || _gameOver) return false;
+        _board.pass();
+        recordMove(GameRecord::PASS);
         endTurn();
-        return;
-    }
-
-    // Find move that flips the most pieces
-    int bestX = -1, bestY = -1, maxFlips = 0;
-
-    for (const auto& move : validMoves) {
-        int x = move.first, y = move.second, totalFlips = 0;
-        for (int i = 0; i < 8; i++) {
-            totalFlips += checkDirection(x, y, DIRECTIONS[i][0], DIRECTIONS[i][1], aiPlayer);
-        }
-        if (totalFlips > maxFlips) {
-            maxFlips = totalFlips;
-            bestX = x;
-            bestY = y;
-        }
-    }
-
-    if (bestX >= 0 && bestY >= 0) {
-        actionForEmptyHolder(*_grid->getSquare(bestX, bestY));
+        return true;
     }
+    ChessSquare* square = _grid->getSquare(move % OthelloBoard::SIZE, move / OthelloBoard::SIZE);
+    return move >= 0 && square && actionForEmptyHolder(*square);
 }
 
 void Othello::getBoardPosition(BitHolder& holder, int &x, int &y) const {
@@ -339,4 +208,4 @@ void Othello::showValidMoves(Player* player) {
 
 void Othello::clearValidMoveIndicators() {
     _showingHints = false;
-}
\ No newline at end of file
+}
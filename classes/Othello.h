@@ -1,6 +1,7 @@
 #pragma once
 #include "Game.h"
-#include <vector>
+#include "OthelloBoard.h"
+#include "OthelloAI.h"
 
 // NOTE: This implementation assumes black.png and white.png exist in resources.
 // If not, you can use o.png and x.png, or any other suitable graphics.
@@ -9,14 +10,13 @@ class Othello : public Game
 {
 public:
     Othello();
-    ~Othello();
+    ~Othello() override;
 
     // Required virtual methods from Game base class
     void        setUpBoard() override;
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
     std::string initialStateString() override;
-    std::string stateString() override;
     void        setStateString(const std::string &s) override;
     bool        actionForEmptyHolder(BitHolder &holder) override;
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
@@ -24,27 +24,25 @@ public:
     void        stopGame() override;
 
     // AI methods
-    void        updateAI() override;
     bool        gameHasAI() override { return true; } // Set to true when AI is implemented
     Grid* getGrid() override { return _grid; }
 
+protected:
+    std::string buildStateString() override;
+    bool        prepareAIMove() override;
+    int         searchAIMove(const std::atomic<bool> &cancel) override;
+    void        applyAIMove(int move) override;
+    bool        replayMove(int move) override;
+
 private:
     // Player constants
     static const int BLACK_PLAYER = 0;
     static const int WHITE_PLAYER = 1;
 
-    // Direction vectors for checking all 8 directions
-    static const int DIRECTIONS[8][2];
-
     // Helper methods
     Bit*        createPiece(Player* player);
-    bool        isValidMove(int x, int y, Player* player) const;
-    int         checkDirection(int x, int y, int dx, int dy, Player* player) const;
-    void        flipPieces(int x, int y, Player* player);
-    void        flipInDirection(int x, int y, int dx, int dy, Player* player, int count);
-    bool        hasValidMove(Player* player) const;
-    void        countPieces(int &blackCount, int &whiteCount) const;
-    std::vector<std::pair<int, int>> getValidMoves(Player* player) const;
+    void        setPieceOwner(Bit* bit, Player* player);
+    void        syncGrid();
     void        showValidMoves(Player* player);
     void        clearValidMoveIndicators();
 
@@ -54,7 +52,16 @@ private:
     // Board representation
     Grid*       _grid;
 
+    // the rules and state live here, the grid is only a view of it
+    OthelloBoard _board;
+    OthelloAI   _ai;
+    // what the worker thread searches, copied when the search starts
+    OthelloBoard _searchBoard;
+    int         _searchMaxDepth;
+    int         _searchTimeBudgetMs;
+
     // Game state
-    int         _consecutivePasses;
     bool        _showingHints;
+    // set once neither side can move, only a move or a new position can change it
+    bool        _gameOver;
 };
\ No newline at end of file
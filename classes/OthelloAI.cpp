@@ -0,0 +1,152 @@
+#include "OthelloAI.h"
+#include <algorithm>
+#include <bit>
+
+static const uint64_t CORNERS = 0x8100000000000081ULL;
+
+// the diagonal neighbour of each corner, in the same order as CORNER_SQUARES
+static const int CORNER_SQUARES[4] = {0, 7, 56, 63};
+static const int X_SQUARES[4] = {9, 14, 49, 54};
+
+// evaluation weights
+static const int MOBILITY_WEIGHT = 10;
+static const int CORNER_WEIGHT = 30;
+static const int X_SQUARE_WEIGHT = 15;
+static const int PARITY_WEIGHT = 5;
+
+// static square values, only used to order moves
+static const int SQUARE_WEIGHTS[OthelloBoard::NUM_SQUARES] = {
+    100, -20,  10,   5,   5,  10, -20, 100,
+    -20, -50,  -2,  -2,  -2,  -2, -50, -20,
+     10,  -2,   1,   1,   1,   1,  -2,  10,
+      5,  -2,   1,   0,   0,   1,  -2,   5,
+      5,  -2,   1,   0,   0,   1,  -2,   5,
+     10,  -2,   1,   1,   1,   1,  -2,  10,
+    -20, -50,  -2,  -2,  -2,  -2, -50, -20,
+    100, -20,  10,   5,   5,  10, -20, 100
+};
+
+// below this depth moves are ordered on square values alone
+static const int MOBILITY_ORDER_DEPTH = 3;
+// ordering penalty per reply a move leaves the opponent
+static const int MOBILITY_ORDER_WEIGHT = 20;
+
+int OthelloSearchState::generateMoves(Move *moves) const
+{
+    uint64_t legal = board.legalMoves();
+    if (!legal) {
+        // the caller has checked for the end of the game, so the opponent can move
+        moves[0].square = PASS;
+        return 1;
+    }
+
+    int count = 0;
+    while (legal) {
+        moves[count++].square = std::countr_zero(legal);
+        legal &= legal - 1;
+    }
+    return count;
+}
+
+// the game is over once neither side can move, score the disc difference for the player to move
+bool OthelloSearchState::isTerminal(int ply, int &score) const
+{
+    int player = board.currentPlayer();
+    if (board.legalMovesFor(player) || board.legalMovesFor(player ^ 1)) {
+        return false;
+    }
+
+    int diff = board.count(player) - board.count(player ^ 1);
+    if (diff > 0) score = RESULT_SCORE + diff;
+    else if (diff < 0) score = -RESULT_SCORE + diff;
+    else score = 0;
+    return true;
+}
+
+int OthelloSearchState::evaluate() const
+{
+    return OthelloAI::evaluate(board);
+}
+
+//
+// static square values, and at depth the moves that leave the opponent the fewest replies
+//
+int OthelloSearchState::orderScore(const Move &move, int depth) const
+{
+    if (move.square == PASS) {
+        return 0;
+    }
+
+    int score = SQUARE_WEIGHTS[move.square];
+    if (depth >= MOBILITY_ORDER_DEPTH) {
+        OthelloBoard next = board;
+        next.play(move.square);
+        score -= MOBILITY_ORDER_WEIGHT * std::popcount(next.legalMoves());
+    }
+    return score;
+}
+
+std::string OthelloSearchState::moveName(const Move &move) const
+{
+    if (move.square == PASS) {
+        return "pass";
+    }
+    std::string name(1, (char)('a' + move.square % OthelloBoard::SIZE));
+    return name + (char)('1' + move.square / OthelloBoard::SIZE);
+}
+
+int OthelloAI::search(const OthelloBoard &board, int maxDepth, int timeBudgetMs, int &bestScore)
+{
+    bestScore = 0;
+    if (!board.legalMoves()) {
+        return -1;
+    }
+
+    // no point looking past the end of the game
+    int empties = std::popcount(board.empty());
+    maxDepth = std::min(std::max(maxDepth, 1), empties);
+
+    OthelloSearchState root;
+    root.board = board;
+    int index = _search.search(root, maxDepth, timeBudgetMs, bestScore);
+    if (index < 0) {
+        return -1;
+    }
+
+    // moves are generated in square order, so the index is the index-th legal square
+    uint64_t legal = board.legalMoves();
+    while (index--) {
+        legal &= legal - 1;
+    }
+    return std::countr_zero(legal);
+}
+
+int OthelloAI::evaluate(const OthelloBoard &board)
+{
+    int player = board.currentPlayer();
+    uint64_t mine = board.board(player);
+    uint64_t theirs = board.board(player ^ 1);
+    uint64_t open = board.empty();
+
+    int score = 0;
+
+    // Mobility: the side with more moves keeps the initiative
+    score += MOBILITY_WEIGHT * (std::popcount(board.legalMovesFor(player)) - std::popcount(board.legalMovesFor(player ^ 1)));
+
+    // Corners can never be flipped back
+    score += CORNER_WEIGHT * (std::popcount(mine & CORNERS) - std::popcount(theirs & CORNERS));
+
+    // a disc diagonal to an empty corner tends to give that corner away
+    uint64_t danger = 0;
+    for (int i = 0; i < 4; i++) {
+        if (open & OthelloBoard::squareMask(CORNER_SQUARES[i])) {
+            danger |= OthelloBoard::squareMask(X_SQUARES[i]);
+        }
+    }
+    score -= X_SQUARE_WEIGHT * (std::popcount(mine & danger) - std::popcount(theirs & danger));
+
+    // Parity: with an odd number of empty squares the player to move gets the last one
+    score += (std::popcount(open) & 1) ? PARITY_WEIGHT : -PARITY_WEIGHT;
+
+    return score;
+}
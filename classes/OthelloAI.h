@@ -0,0 +1,90 @@
+#pragma once
+#include "OthelloBoard.h"
+#include "Search.h"
+#include <cstdint>
+#include <atomic>
+
+//
+// an OthelloBoard as Search<> sees it
+// a pass is a move of its own, and a finished game scores its disc difference
+// beyond anything the evaluation can reach
+//
+struct OthelloSearchState
+{
+    struct Move {
+        int         square;     // PASS for a pass
+        uint64_t    flips;      // filled in by makeMove so the move can be taken back
+    };
+
+    static const int PASS = OthelloBoard::NUM_SQUARES;
+    static const int MAX_MOVES = OthelloBoard::NUM_SQUARES;
+    static const int MOVE_IDS = OthelloBoard::NUM_SQUARES + 1;
+    // othello has no quick wins to prefer, finished games use RESULT_SCORE instead
+    static const int WIN_SCORE = 30000;
+    static const int RESULT_SCORE = 10000;
+
+    OthelloBoard board;
+
+    int         generateMoves(Move *moves) const;
+    void        makeMove(Move &move)
+    {
+        if (move.square == PASS) board.pass();
+        else move.flips = board.play(move.square);
+    }
+    void        unmakeMove(const Move &move)
+    {
+        if (move.square == PASS) board.pass();
+        else board.undo(move.square, move.flips);
+    }
+    bool        isTerminal(int ply, int &score) const;
+    bool        isQuiet() const { return true; }
+    int         evaluate() const;
+    uint64_t    key() const { return board.key(); }
+    int         moveId(const Move &move) const { return move.square; }
+    int         orderScore(const Move &move, int depth) const;
+    // a pass doesn't use up depth, two in a row end the game
+    int         extension(const Move &move) const { return move.square == PASS ? 1 : 0; }
+    // the column letter and row number, or "pass"
+    std::string moveName(const Move &move) const;
+};
+static_assert(SearchState<OthelloSearchState>);
+
+
+//
+// principal variation search for othello, Search<> over OthelloSearchState
+// works entirely on an OthelloBoard, making and taking back moves in place,
+// so it never touches the grid, the sprites or a state string
+//
+// leaves are scored on mobility, corners and parity; once the search reaches
+// the end of the game it scores the real disc count instead
+//
+class OthelloAI
+{
+public:
+    // finished games score beyond this, plus the disc difference
+    static const int WIN_SCORE = OthelloSearchState::RESULT_SCORE;
+
+    // iterative deepening up to maxDepth, stopping once timeBudgetMs runs out (0 means no limit)
+    // returns the best square of the last completed iteration or -1 if there are no moves
+    int         search(const OthelloBoard &board, int maxDepth, int timeBudgetMs, int &bestScore);
+    // search the position to a fixed depth
+    int         bestMove(const OthelloBoard &board, int depth, int &bestScore) { return search(board, depth, 0, bestScore); }
+    // static evaluation from the point of view of the player to move
+    static int  evaluate(const OthelloBoard &board);
+
+    // nodes searched during the last search
+    uint64_t    nodes() const { return _search.nodes(); }
+    int         completedDepth() const { return _search.completedDepth(); }
+    // depth, cutoffs, table use and principal variation of the last search
+    const SearchStats &stats() const { return _search.stats(); }
+
+    // optional flag another thread can set to abandon the search
+    void        setStopFlag(const std::atomic<bool> *flag) { _search.setStopFlag(flag); }
+
+    // transposition table budget, the table is kept between moves
+    void        setTableSize(size_t megabytes) { _search.setTableSize(megabytes); }
+    void        clearTable() { _search.clearTable(); }
+
+private:
+    Search<OthelloSearchState> _search;
+};
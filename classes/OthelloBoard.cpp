@@ -0,0 +1,125 @@
+#include "OthelloBoard.h"
+#include <bit>
+
+static const uint64_t NOT_FILE_A = 0xfefefefefefefefeULL;   // x != 0
+static const uint64_t NOT_FILE_H = 0x7f7f7f7f7f7f7f7fULL;   // x != 7
+
+//
+// the eight directions as a shift and the mask that keeps lines from wrapping
+// around a row: anything that lands on the file it can't reach is dropped
+// N, NE, E, SE, S, SW, W, NW
+//
+static const int DIRECTION_SHIFTS[8] = {-8, -7, 1, 9, 8, 7, -1, -9};
+static const uint64_t DIRECTION_MASKS[8] = {
+    ~0ULL, NOT_FILE_A, NOT_FILE_A, NOT_FILE_A,
+    ~0ULL, NOT_FILE_H, NOT_FILE_H, NOT_FILE_H
+};
+
+static inline uint64_t shiftBy(uint64_t b, int shift)
+{
+    return (shift > 0) ? (b << shift) : (b >> -shift);
+}
+
+//
+// Kogge-Stone occluded fill: spread gen through the propagator squares in one
+// direction in three doubling steps instead of one square at a time
+// pro must already be masked for the direction
+//
+static inline uint64_t occludedFill(uint64_t gen, uint64_t pro, int shift)
+{
+    gen |= pro & shiftBy(gen, shift);
+    pro &= shiftBy(pro, shift);
+    gen |= pro & shiftBy(gen, 2 * shift);
+    pro &= shiftBy(pro, 2 * shift);
+    gen |= pro & shiftBy(gen, 4 * shift);
+    return gen;
+}
+
+void OthelloBoard::reset()
+{
+    _boards[0] = squareMask(3 * SIZE + 4) | squareMask(4 * SIZE + 3);  // black at (4,3) and (3,4)
+    _boards[1] = squareMask(3 * SIZE + 3) | squareMask(4 * SIZE + 4);  // white at (3,3) and (4,4)
+    _player = 0;
+}
+
+int OthelloBoard::count(int player) const
+{
+    return std::popcount(_boards[player]);
+}
+
+uint64_t OthelloBoard::legalMovesFor(int player) const
+{
+    uint64_t own = _boards[player];
+    uint64_t opp = _boards[player ^ 1];
+    uint64_t open = empty();
+    uint64_t moves = 0;
+
+    // fill out from our discs over the opponent's, an empty square just past a run is a move
+    for (int dir = 0; dir < 8; dir++) {
+        int shift = DIRECTION_SHIFTS[dir];
+        uint64_t mask = DIRECTION_MASKS[dir];
+        uint64_t run = occludedFill(own, opp & mask, shift) & ~own;
+        moves |= shiftBy(run, shift) & mask & open;
+    }
+    return moves;
+}
+
+uint64_t OthelloBoard::flipsFor(int square) const
+{
+    uint64_t start = squareMask(square);
+    if (!(start & empty())) return 0;
+
+    uint64_t own = _boards[_player];
+    uint64_t opp = _boards[_player ^ 1];
+    uint64_t flips = 0;
+
+    // fill out from the new disc over the opponent's, keep the run if one of ours closes it
+    for (int dir = 0; dir < 8; dir++) {
+        int shift = DIRECTION_SHIFTS[dir];
+        uint64_t mask = DIRECTION_MASKS[dir];
+        uint64_t line = occludedFill(start, opp & mask, shift);
+        if (shiftBy(line, shift) & mask & own) {
+            flips |= line & ~start;
+        }
+    }
+    return flips;
+}
+
+uint64_t OthelloBoard::play(int square)
+{
+    uint64_t flips = flipsFor(square);
+    _boards[_player] ^= flips | squareMask(square);
+    _boards[_player ^ 1] ^= flips;
+    _player ^= 1;
+    return flips;
+}
+
+void OthelloBoard::undo(int square, uint64_t flips)
+{
+    _player ^= 1;
+    _boards[_player] ^= flips | squareMask(square);
+    _boards[_player ^ 1] ^= flips;
+}
+
+bool OthelloBoard::setStateString(const std::string &s)
+{
+    if (s.length() != (size_t)NUM_SQUARES) return false;
+
+    _boards[0] = 0;
+    _boards[1] = 0;
+    for (int i = 0; i < NUM_SQUARES; i++) {
+        if (s[i] == '1') _boards[0] |= squareMask(i);
+        else if (s[i] == '2') _boards[1] |= squareMask(i);
+    }
+    return true;
+}
+
+std::string OthelloBoard::stateString() const
+{
+    std::string state(NUM_SQUARES, '0');
+    for (int i = 0; i < NUM_SQUARES; i++) {
+        if (_boards[0] & squareMask(i)) state[i] = '1';
+        else if (_boards[1] & squareMask(i)) state[i] = '2';
+    }
+    return state;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <string>
+
+//
+// othello rules on two bitboards, with no grid or sprites attached
+// square index is y * 8 + x, the same order as the game's state string
+// player 0 is black ('1' in state strings) and moves first
+//
+class OthelloBoard
+{
+public:
+    static const int SIZE = 8;
+    static const int NUM_SQUARES = SIZE * SIZE;
+
+    OthelloBoard() { reset(); }
+
+    // standard starting position, black to move
+    void        reset();
+
+    int         currentPlayer() const { return _player; }
+    void        setCurrentPlayer(int player) { _player = player & 1; }
+    uint64_t    board(int player) const { return _boards[player]; }
+    uint64_t    empty() const { return ~(_boards[0] | _boards[1]); }
+    int         count(int player) const;
+    // hash of the discs and the player to move, for transposition tables
+    uint64_t    key() const
+    {
+        uint64_t h = (_boards[0] * 0x9E3779B97F4A7C15ULL) ^ std::rotl(_boards[1] * 0xC2B2AE3D27D4EB4FULL, 31);
+        h ^= h >> 29;
+        h *= 0xD6E8FEB86659FD93ULL;
+        h ^= h >> 32;
+        return h ^ (uint64_t)_player;
+    }
+
+    // bitboard of squares the player to move can play
+    uint64_t    legalMoves() const { return legalMovesFor(_player); }
+    uint64_t    legalMovesFor(int player) const;
+    // discs that playing this square would turn over, zero if the move is illegal
+    uint64_t    flipsFor(int square) const;
+
+    // place a disc for the player to move, flip and hand the move over
+    // returns the flipped discs so the move can be taken back with undo
+    uint64_t    play(int square);
+    void        undo(int square, uint64_t flips);
+    // the player to move has nothing legal and gives the turn away
+    void        pass() { _player ^= 1; }
+    bool        isGameOver() const { return legalMovesFor(0) == 0 && legalMovesFor(1) == 0; }
+
+    // row-major '0'/'1'/'2' strings, the player to move is not part of the string
+    bool        setStateString(const std::string &s);
+    std::string stateString() const;
+
+    static uint64_t squareMask(int square) { return 1ULL << square; }
+
+private:
+    uint64_t    _boards[2];
+    int         _player;
+};
@@ -7,7 +7,8 @@ class Game;
 class Player
 {
 public:
-	Player() : _game(nullptr), _name(""), _extraValues(), _aiPlayer(false) {};
+	Player() : _game(nullptr), _name(""), _aiPlayer(false), _extraValues() {};
+	Player(Game *game) : _game(game), _name(""), _aiPlayer(false), _extraValues() {};
 	~Player() {};
 
 	static Player *initWithGame(Game *game) { Player *player = new Player(); player->_game = game; return player;}
@@ -0,0 +1,414 @@
+#pragma once
+#include "TranspositionTable.h"
+#include "SearchStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+//
+// what a game has to provide to be searched by Search<State>
+//
+//   Move                       whatever a move is, makeMove may write its undo information into it
+//   MAX_MOVES                  most moves a position can have
+//   MOVE_IDS                   moves map to ids in [0, MOVE_IDS) for the killer, history and table moves
+//   WIN_SCORE                  scores within Search::MAX_PLY of this are wins, counted down by the ply
+//
+//   generateMoves(moves)       fills the list and returns how many, a pass has to be a move of its own
+//   makeMove(move)             plays a move, unmakeMove(move) takes it back
+//   isTerminal(ply, score)     true once the game is over, with the score for the player to move
+//   isQuiet()                  false while the horizon has to be pushed on, e.g. a forced capture
+//   evaluate()                 static score for the player to move
+//   key()                      hash of the position for the transposition table
+//   moveId(move)               the move's id
+//   orderScore(move, depth)    static ordering hint, higher is tried first
+//   extension(move)            extra depth the move earns, e.g. 1 for a forced pass
+//   moveName(move)             the move as the game writes it, for the principal variation
+//
+template <typename State>
+concept SearchState = requires(State state, const State constState, typename State::Move move,
+                               typename State::Move *moves, int ply, int &score) {
+    { State::MAX_MOVES } -> std::convertible_to<int>;
+    { State::MOVE_IDS } -> std::convertible_to<int>;
+    { State::WIN_SCORE } -> std::convertible_to<int>;
+    { constState.generateMoves(moves) } -> std::convertible_to<int>;
+    state.makeMove(move);
+    state.unmakeMove(move);
+    { constState.isTerminal(ply, score) } -> std::convertible_to<bool>;
+    { constState.isQuiet() } -> std::convertible_to<bool>;
+    { constState.evaluate() } -> std::convertible_to<int>;
+    { constState.key() } -> std::convertible_to<uint64_t>;
+    { constState.moveId(move) } -> std::convertible_to<int>;
+    { constState.orderScore(move, ply) } -> std::convertible_to<int>;
+    { constState.extension(move) } -> std::convertible_to<int>;
+    { constState.moveName(move) } -> std::convertible_to<std::string>;
+};
+
+//
+// principal variation search shared by the game engines
+// iterative deepening under a time budget, a transposition table, killer moves per
+// ply and a history table for ordering, and a quiescence extension while the state
+// says the position isn't quiet; everything is resolved at compile time for the
+// state type, so there are no virtual calls in the search
+//
+template <SearchState State>
+class Search
+{
+public:
+    using Move = typename State::Move;
+
+    // deepest ply the search will reach, quiescence included
+    static const int MAX_PLY = 128;
+
+    Search()
+    {
+        _nodes = 0;
+        _completedDepth = 0;
+        _stopped = false;
+        _timeBudgetMs = 0;
+        _timed = false;
+        _stopFlag = nullptr;
+        clearOrdering();
+    }
+
+    // iterative deepening up to maxDepth, stopping once timeBudgetMs runs out (0 means no limit)
+    // returns the index of the best move in root.generateMoves order, -1 if there are no moves
+    int search(const State &root, int maxDepth, int timeBudgetMs, int &bestScore)
+    {
+        auto start = std::chrono::steady_clock::now();
+        _stats = SearchStats();
+        _nodes = 0;
+        _completedDepth = 0;
+        _stopped = false;
+        _timeBudgetMs = timeBudgetMs;
+        _timed = false;
+        _table.newSearch();
+        _state = root;
+        bestScore = 0;
+
+        int terminalScore;
+        if (_state.isTerminal(0, terminalScore)) {
+            return -1;
+        }
+
+        // history from the last move is still a good guess, just weaker
+        for (int i = 0; i < State::MOVE_IDS; i++) {
+            _history[i] /= 8;
+        }
+        std::memset(_killers, -1, sizeof(_killers));
+
+        maxDepth = std::min(std::max(maxDepth, 1), MAX_PLY / 2);
+        _deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeBudgetMs);
+
+        int bestMove = -1;
+        for (int depth = 1; depth <= maxDepth; depth++) {
+            // the previous iteration's best move is searched first
+            int score = 0;
+            int move = searchRoot(depth, bestMove, score);
+            if (_stopped) break;
+
+            bestMove = move;
+            bestScore = score;
+            _completedDepth = depth;
+
+            // a forced win or loss won't change with more depth
+            if (isWinScore(score)) break;
+
+            _timed = (_timeBudgetMs > 0);
+            if (_timed && std::chrono::steady_clock::now() >= _deadline) break;
+        }
+
+        _stats.nodes = _nodes;
+        _stats.completedDepth = _completedDepth;
+        _stats.score = bestScore;
+        if (bestMove >= 0) {
+            collectPV(root, bestMove);
+        }
+        _stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return bestMove;
+    }
+
+    // nodes searched during the last search
+    uint64_t    nodes() const { return _nodes; }
+    int         completedDepth() const { return _completedDepth; }
+    // everything else about the last search
+    const SearchStats &stats() const { return _stats; }
+
+    // optional flag another thread can set to abandon the search
+    void        setStopFlag(const std::atomic<bool> *flag) { _stopFlag = flag; }
+
+    // transposition table budget, the table is kept between moves
+    void        setTableSize(size_t megabytes) { _table.resize(megabytes); }
+    void        clearTable() { _table.clear(); clearOrdering(); }
+
+private:
+    static bool isWinScore(int score) { return std::abs(score) >= State::WIN_SCORE - MAX_PLY; }
+
+    //
+    // win scores count down with the ply from the root, the table stores them relative
+    // to the node instead so a transposed win keeps the right distance
+    //
+    static int scoreToTable(int score, int ply)
+    {
+        if (score >= State::WIN_SCORE - MAX_PLY) return score + ply;
+        if (score <= -State::WIN_SCORE + MAX_PLY) return score - ply;
+        return score;
+    }
+
+    static int scoreFromTable(int score, int ply)
+    {
+        if (score >= State::WIN_SCORE - MAX_PLY) return score - ply;
+        if (score <= -State::WIN_SCORE + MAX_PLY) return score + ply;
+        return score;
+    }
+
+    //
+    // the best move, then the table's move from each position after it, for as deep
+    // as the search completed; stops early where the table has lost the line
+    //
+    void collectPV(const State &root, int bestMove)
+    {
+        _state = root;
+        Move moves[State::MAX_MOVES];
+        _state.generateMoves(moves);
+        Move move = moves[bestMove];
+
+        for (int ply = 1; ply <= std::max(_completedDepth, 1); ply++) {
+            _stats.pv.push_back(_state.moveName(move));
+            _state.makeMove(move);
+
+            int score;
+            TranspositionTable::Entry entry;
+            if (ply == _completedDepth || _state.isTerminal(ply, score) || !_table.probe(_state.key(), entry)) break;
+
+            int count = _state.generateMoves(moves);
+            int next = 0;
+            while (next < count && _state.moveId(moves[next]) != entry.move) next++;
+            if (next == count) break;
+            move = moves[next];
+        }
+    }
+
+    void clearOrdering()
+    {
+        std::memset(_killers, -1, sizeof(_killers));
+        std::memset(_history, 0, sizeof(_history));
+    }
+
+    bool shouldStop()
+    {
+        // only look at the clock and the stop flag every thousand nodes or so
+        if ((_nodes & 1023) == 0 && !_stopped) {
+            if (_stopFlag && _stopFlag->load(std::memory_order_relaxed)) {
+                _stopped = true;
+            } else if (_timed && std::chrono::steady_clock::now() >= _deadline) {
+                _stopped = true;
+            }
+        }
+        return _stopped;
+    }
+
+    //
+    // order moves best first into order[]: the table move, the two killers for this
+    // ply, then the state's own hint with the history table breaking ties
+    //
+    void orderMoves(const Move *moves, int count, int ttMove, int depth, int ply, int *order)
+    {
+        int64_t keys[State::MAX_MOVES];
+        for (int n = 0; n < count; n++) {
+            int id = _state.moveId(moves[n]);
+            int64_t key;
+            if (id == ttMove) {
+                key = INT64_MAX;
+            } else if (id == _killers[ply][0]) {
+                key = INT64_MAX - 1;
+            } else if (id == _killers[ply][1]) {
+                key = INT64_MAX - 2;
+            } else {
+                key = (int64_t)_state.orderScore(moves[n], depth) * (1LL << 32) + _history[id];
+            }
+
+            // insertion sort, move lists are short
+            int i = n;
+            while (i > 0 && keys[i - 1] < key) {
+                keys[i] = keys[i - 1];
+                order[i] = order[i - 1];
+                i--;
+            }
+            keys[i] = key;
+            order[i] = n;
+        }
+    }
+
+    bool probeTable(uint64_t key, TranspositionTable::Entry &entry)
+    {
+        _stats.ttProbes++;
+        if (!_table.probe(key, entry)) return false;
+        _stats.ttHits++;
+        return true;
+    }
+
+    // a move that caused a cutoff is worth trying early elsewhere
+    void rememberCutoff(int id, int depth, int ply)
+    {
+        if (_killers[ply][0] != id) {
+            _killers[ply][1] = _killers[ply][0];
+            _killers[ply][0] = id;
+        }
+        _history[id] += depth * depth;
+    }
+
+    int searchRoot(int depth, int firstMove, int &bestScore)
+    {
+        Move moves[State::MAX_MOVES];
+        int count = _state.generateMoves(moves);
+
+        int ttMove = (firstMove >= 0) ? _state.moveId(moves[firstMove]) : -1;
+        TranspositionTable::Entry entry;
+        if (ttMove < 0 && probeTable(_state.key(), entry)) {
+            ttMove = entry.move;
+        }
+        int order[State::MAX_MOVES];
+        orderMoves(moves, count, ttMove, depth, 0, order);
+
+        int bestMove = -1;
+        int alpha = -INT_MAX;
+        int beta = INT_MAX;
+        bestScore = -INT_MAX;
+
+        for (int i = 0; i < count; i++) {
+            Move &move = moves[order[i]];
+            int childDepth = depth - 1 + _state.extension(move);
+            _state.makeMove(move);
+            int score;
+            if (i == 0) {
+                score = -negamax(childDepth, -beta, -alpha, 1);
+            } else {
+                // prove the rest are no better with a null window, search again if one is
+                score = -negamax(childDepth, -alpha - 1, -alpha, 1);
+                if (score > alpha && !_stopped) {
+                    score = -negamax(childDepth, -beta, -alpha, 1);
+                }
+            }
+            _state.unmakeMove(move);
+            if (_stopped) return bestMove;
+
+            if (score > bestScore) {
+                bestScore = score;
+                bestMove = order[i];
+            }
+            alpha = std::max(alpha, score);
+        }
+
+        if (bestMove >= 0) {
+            _table.store(_state.key(), depth, TranspositionTable::BOUND_EXACT, scoreToTable(bestScore, 0),
+                         _state.moveId(moves[bestMove]));
+        }
+        return bestMove;
+    }
+
+    int negamax(int depth, int alpha, int beta, int ply)
+    {
+        _nodes++;
+        if (shouldStop()) {
+            return 0; // result is thrown away
+        }
+
+        int score;
+        if (_state.isTerminal(ply, score)) {
+            return score;
+        }
+        if (ply >= MAX_PLY - 1) {
+            return _state.evaluate();
+        }
+
+        // at the horizon only positions the state calls unsettled are searched on
+        if (depth <= 0) {
+            if (_state.isQuiet()) {
+                return _state.evaluate();
+            }
+            depth = 0;
+        }
+
+        // Transposition table: cut off on a deep enough result, otherwise just use its move
+        uint64_t key = _state.key();
+        int ttMove = -1;
+        TranspositionTable::Entry entry;
+        if (probeTable(key, entry)) {
+            ttMove = entry.move;
+            if (entry.depth >= depth) {
+                int tableScore = scoreFromTable(entry.score, ply);
+                if (entry.bound == TranspositionTable::BOUND_EXACT) return tableScore;
+                if (entry.bound == TranspositionTable::BOUND_LOWER && tableScore >= beta) return tableScore;
+                if (entry.bound == TranspositionTable::BOUND_UPPER && tableScore <= alpha) return tableScore;
+            }
+        }
+
+        Move moves[State::MAX_MOVES];
+        int count = _state.generateMoves(moves);
+        int order[State::MAX_MOVES];
+        orderMoves(moves, count, ttMove, depth, ply, order);
+
+        int alphaOrig = alpha;
+        int maxScore = -INT_MAX;
+        int bestMove = -1;
+
+        for (int i = 0; i < count; i++) {
+            Move &move = moves[order[i]];
+            int childDepth = std::max(depth - 1, 0) + _state.extension(move);
+            _state.makeMove(move);
+            if (i == 0) {
+                score = -negamax(childDepth, -beta, -alpha, ply + 1);
+            } else {
+                score = -negamax(childDepth, -alpha - 1, -alpha, ply + 1);
+                if (score > alpha && score < beta && !_stopped) {
+                    score = -negamax(childDepth, -beta, -alpha, ply + 1);
+                }
+            }
+            _state.unmakeMove(move);
+            if (_stopped) return 0;
+
+            if (score > maxScore) {
+                maxScore = score;
+                bestMove = order[i];
+            }
+
+            alpha = std::max(alpha, score);
+            if (alpha >= beta) {
+                _stats.cutoffs++;
+                rememberCutoff(_state.moveId(move), std::max(depth, 1), ply);
+                break; // Alpha-beta pruning
+            }
+        }
+
+        TranspositionTable::Bound bound = TranspositionTable::BOUND_EXACT;
+        if (maxScore <= alphaOrig) {
+            bound = TranspositionTable::BOUND_UPPER;
+        } else if (maxScore >= beta) {
+            bound = TranspositionTable::BOUND_LOWER;
+        }
+        int bestId = (bestMove >= 0) ? _state.moveId(moves[bestMove]) : -1;
+        _table.store(key, depth, bound, scoreToTable(maxScore, ply), bestId);
+
+        return maxScore;
+    }
+
+    State               _state;
+    TranspositionTable  _table;
+    int                 _killers[MAX_PLY][2];
+    int64_t             _history[State::MOVE_IDS];
+    uint64_t            _nodes;
+    int                 _completedDepth;
+    SearchStats         _stats;
+    bool                _stopped;
+    // time control, only armed once the first iteration has a move
+    int                 _timeBudgetMs;
+    bool                _timed;
+    std::chrono::steady_clock::time_point _deadline;
+    const std::atomic<bool> *_stopFlag;
+};
@@ -0,0 +1,39 @@
+#include "SearchStats.h"
+#include <cstdio>
+
+std::string SearchStats::pvString() const
+{
+    std::string text;
+    for (const std::string &move : pv) {
+        if (!text.empty()) text += ' ';
+        text += move;
+    }
+    return text;
+}
+
+std::string SearchStats::toString() const
+{
+    char line[256];
+    snprintf(line, sizeof(line), "%s: depth %d, score %d, %llu nodes in %.1f ms (%.0f nodes/s), %llu cutoffs, tt %.1f%% of %llu | pv ",
+             source.c_str(), completedDepth, score, (unsigned long long)nodes, seconds * 1000.0, nodesPerSecond(),
+             (unsigned long long)cutoffs, ttHitRate() * 100.0, (unsigned long long)ttProbes);
+    return line + pvString();
+}
+
+// move names are plain letters, digits and dashes, so nothing in them needs escaping
+std::string SearchStats::toJson() const
+{
+    char fields[384];
+    snprintf(fields, sizeof(fields),
+             "{\"source\": \"%s\", \"depth\": %d, \"score\": %d, \"nodes\": %llu, \"seconds\": %.6f, \"nps\": %.0f, "
+             "\"cutoffs\": %llu, \"tt_probes\": %llu, \"tt_hits\": %llu, \"pv\": [",
+             source.c_str(), completedDepth, score, (unsigned long long)nodes, seconds, nodesPerSecond(),
+             (unsigned long long)cutoffs, (unsigned long long)ttProbes, (unsigned long long)ttHits);
+    std::string json = fields;
+    for (size_t i = 0; i < pv.size(); i++) {
+        if (i) json += ", ";
+        json += "\"" + pv[i] + "\"";
+    }
+    json += "]}";
+    return json;
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// what one AI search did, filled in by the engine at the end of every search
+// counts cover every search thread; the principal variation is read back out of the
+// transposition table, so it can stop short of the completed depth where entries
+// were overwritten
+//
+struct SearchStats
+{
+    // where the move came from, a search unless a book or solver answered first
+    std::string source = "search";
+    uint64_t    nodes = 0;
+    double      seconds = 0.0;
+    int         completedDepth = 0;
+    int         score = 0;
+    // moves that failed high and cut off their siblings
+    uint64_t    cutoffs = 0;
+    uint64_t    ttProbes = 0;
+    uint64_t    ttHits = 0;
+    // best line from the root, as the game names its moves
+    std::vector<std::string> pv;
+
+    double      nodesPerSecond() const { return seconds > 0.0 ? nodes / seconds : 0.0; }
+    double      ttHitRate() const { return ttProbes ? (double)ttHits / ttProbes : 0.0; }
+    std::string pvString() const;
+
+    // one line for the log
+    std::string toString() const;
+    // one JSON object on a single line
+    std::string toJson() const;
+};
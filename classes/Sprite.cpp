@@ -3,31 +3,90 @@
 #include "stb_image.h"
 #include <iostream>
 #include <filesystem>
+#include <unordered_map>
+
+//
+// one uploaded texture and the number of sprites drawing with it
+//
+struct CachedTexture
+{
+    ImTextureID texture;
+    ImVec2      size;
+    int         refCount;
+};
+
+// textures are only loaded and released on the main thread
+static std::unordered_map<std::string, CachedTexture> &textureCache()
+{
+    static std::unordered_map<std::string, CachedTexture> cache;
+    return cache;
+}
 
 // Simple helper function to load an image into a OpenGL texture with common settings
 bool Sprite::LoadTextureFromFile(const char* filename)
 {
-    // Load from file
-    int image_width = 0;
-    int image_height = 0;
-    std::filesystem::path resourcePath = std::filesystem::path("resources") / filename;
-    std::string newFilename = resourcePath.string();
-    unsigned char* image_data = stbi_load(newFilename.c_str(), &image_width, &image_height, NULL, 4);
-    if (image_data == NULL) {
-        _size = ImVec2(0, 0);
-        std::cout << "Failed to load texture: " << newFilename << std::endl;
-        return false;
-    }
-    _texture = _loadTextureFromMemory(image_data, image_width, image_height);
-    stbi_image_free(image_data);
-    if (_texture == 0) {
-        _size = ImVec2(0, 0);
-        return false;
+    auto &cache = textureCache();
+    auto it = cache.find(filename);
+    if (it == cache.end()) {
+        // Load from file
+        int image_width = 0;
+        int image_height = 0;
+        std::filesystem::path resourcePath = std::filesystem::path("resources") / filename;
+        std::string newFilename = resourcePath.string();
+        unsigned char* image_data = stbi_load(newFilename.c_str(), &image_width, &image_height, NULL, 4);
+        if (image_data == NULL) {
+            releaseTexture();
+            _size = ImVec2(0, 0);
+            std::cout << "Failed to load texture: " << newFilename << std::endl;
+            return false;
+        }
+        ImTextureID texture = _loadTextureFromMemory(image_data, image_width, image_height);
+        stbi_image_free(image_data);
+        if (texture == 0) {
+            releaseTexture();
+            _size = ImVec2(0, 0);
+            return false;
+        }
+        it = cache.emplace(filename, CachedTexture{texture, ImVec2((float)image_width, (float)image_height), 0}).first;
     }
-    _size = ImVec2((float)image_width, (float)image_height);
+
+    // take the new reference before dropping the old one, it may be the same texture
+    it->second.refCount++;
+    releaseTexture();
+    _texture = it->second.texture;
+    _size = it->second.size;
+    _textureName = filename;
     return true;
 }
 
+void Sprite::releaseTexture()
+{
+    if (_textureName.empty()) {
+        return;
+    }
+    // the entry outlives its last sprite, resetting a game would otherwise decode it again
+    auto &cache = textureCache();
+    auto it = cache.find(_textureName);
+    if (it != cache.end()) {
+        it->second.refCount--;
+    }
+    _textureName.clear();
+    _texture = 0;
+}
+
+void Sprite::purgeTextureCache()
+{
+    auto &cache = textureCache();
+    for (auto it = cache.begin(); it != cache.end();) {
+        if (it->second.refCount <= 0) {
+            _freeTexture(it->second.texture);
+            it = cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void Sprite::setHighlighted(bool highlighted)
 {
 	if (highlighted != _highlighted) {
@@ -40,7 +99,20 @@ bool Sprite::highlighted()
 	return _highlighted;
 }
 
-#ifdef __APPLE__
+#if defined(HEADLESS)
+
+// tools built without a window have nothing to upload to, their sprites draw nothing;
+// the texture still gets an id so it is cached and not decoded again for every piece
+ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
+{
+    return 1;
+}
+
+void Sprite::_freeTexture(ImTextureID texture)
+{
+}
+
+#elif defined(__APPLE__)
 #include "../imgui/imgui_impl_opengl3_loader.h"
 
 ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height)
@@ -60,6 +132,12 @@ ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int
     return static_cast<ImTextureID>(image_texture);
 }
 
+void Sprite::_freeTexture(ImTextureID texture)
+{
+    GLuint image_texture = (GLuint)(intptr_t)texture;
+    glDeleteTextures(1, &image_texture);
+}
+
 #else
 
 // DirectX
@@ -117,5 +195,13 @@ ImTextureID Sprite::_loadTextureFromMemory(const unsigned char *image_data, int
     }
     return reinterpret_cast<ImTextureID>(shaderResourceView);
 }
+
+void Sprite::_freeTexture(ImTextureID texture)
+{
+    ID3D11ShaderResourceView* shaderResourceView = reinterpret_cast<ID3D11ShaderResourceView*>(texture);
+    if (shaderResourceView) {
+        shaderResourceView->Release();
+    }
+}
 #endif
 
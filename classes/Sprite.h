@@ -1,6 +1,7 @@
 #pragma once
 #include "Entity.h"
 #include "../imgui/imgui.h"
+#include <string>
 
 class Sprite : public Entity
 {
@@ -16,11 +17,15 @@ public:
         _scale(1),
         _color(1, 1, 1, 1),
         _localZOrder(0),
+        _texture(0),
         _highlighted(false)
         { 
             _entityType = EntitySprite;
         };
-    ~Sprite() { if (_retainCount > 0) release(); }
+    ~Sprite() override { releaseTexture(); }
+    // sprites share cached textures by reference count, so they can't be copied
+    Sprite(const Sprite &) = delete;
+    Sprite &operator=(const Sprite &) = delete;
     
     // set the texture to use for this sprite
     void setPosition(float x, float y)
@@ -75,7 +80,14 @@ public:
         return (mousePos.x >= _location.x && mousePos.x <= _location.x + _size.x && mousePos.y >= _location.y && mousePos.y <= _location.y + _size.y);
     }
 
+    // textures come from a process-wide cache keyed by resource name, so each file
+    // is decoded and uploaded once however many sprites show it; a sprite whose load
+    // fails is left with no texture
     bool LoadTextureFromFile(const char* filename);
+    // drop this sprite's reference, the texture stays cached for the next game
+    void releaseTexture();
+    // free every cached texture no sprite is using, before the graphics device goes away
+    static void purgeTextureCache();
 	
     // set the highlighted state
 	virtual void	setHighlighted(bool yes);
@@ -102,8 +114,11 @@ protected:
     int _localZOrder;
     // the texture we're going to draw
     ImTextureID _texture;
+    // the cache entry _texture came from, empty if there isn't one
+    std::string _textureName;
     // currently highlighted
    	bool	_highlighted;
     // private platform specific texture loading
     ImTextureID _loadTextureFromMemory(const unsigned char *image_data, int image_width, int image_height);
+    static void _freeTexture(ImTextureID texture);
 };
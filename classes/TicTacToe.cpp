@@ -1,4 +1,5 @@
 #include "TicTacToe.h"
+#include "TicTacToeSolver.h"
 
 
 TicTacToe::TicTacToe()
@@ -17,13 +18,39 @@ TicTacToe::~TicTacToe()
 Bit* TicTacToe::PieceForPlayer(const int playerNumber)
 {
     // depending on playerNumber load the "x.png" or the "o.png" graphic
-    Bit *bit = new Bit();
+    Bit *bit = newBit();
     // should possibly be cached from player class?
     bit->LoadTextureFromFile(playerNumber == AI_PLAYER ? "o.png" : "x.png");
     bit->setOwner(getPlayerAt(playerNumber == AI_PLAYER ? 1 : 0));
+    bit->setGameTag(playerNumber == AI_PLAYER ? 2 : 1);
     return bit;
 }
 
+//
+// mirror _board into the grid, only touching squares whose piece changed
+//
+void TicTacToe::syncGrid()
+{
+    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
+        int index = y * 3 + x;
+        int want = 0;
+        if ((_board.board(0) >> index) & 1) want = 1;
+        else if ((_board.board(1) >> index) & 1) want = 2;
+
+        Bit* bit = square->bit();
+        if ((bit ? bit->gameTag() : 0) == want) return;
+        invalidateStateString();
+
+        if (want == 0) {
+            square->destroyBit();
+            return;
+        }
+        Bit* piece = PieceForPlayer(want == 2 ? AI_PLAYER : HUMAN_PLAYER);
+        piece->setPosition(square->getPosition());
+        square->setBit(piece);
+    });
+}
+
 void TicTacToe::setUpBoard()
 {
     setNumberOfPlayers(2);
@@ -43,17 +70,23 @@ void TicTacToe::setUpBoard()
 //
 bool TicTacToe::actionForEmptyHolder(BitHolder &holder)
 {
-    if (holder.bit()) {
+    ChessSquare* square = static_cast<ChessSquare*>(&holder);
+    int index = square->getRow() * 3 + square->getColumn();
+    if (!_board.canPlay(index)) {
         return false;
     }
-    Bit *bit = PieceForPlayer(getCurrentPlayer()->playerNumber() == 0 ? HUMAN_PLAYER : AI_PLAYER);
-    if (bit) {
-        bit->setPosition(holder.getPosition());
-        holder.setBit(bit);
-        endTurn();
-        return true;
-    }   
-    return false;
+    _board.play(index);
+    syncGrid();
+    recordMove(index);
+    endTurn();
+    return true;
+}
+
+// moves are recorded as the square index
+bool TicTacToe::replayMove(int move)
+{
+    ChessSquare* square = _grid->getSquare(move % 3, move / 3);
+    return move >= 0 && square && actionForEmptyHolder(*square);
 }
 
 bool TicTacToe::canBitMoveFrom(Bit &bit, BitHolder &src)
@@ -73,47 +106,20 @@ bool TicTacToe::canBitMoveFromTo(Bit &bit, BitHolder &src, BitHolder &dst)
 //
 void TicTacToe::stopGame()
 {
-    _grid->forEachSquare([](ChessSquare* square, int x, int y) {
-        square->destroyBit();
-    });
-}
-
-//
-// helper function for the winner check
-//
-Player* TicTacToe::ownerAt(int index ) const
-{
-    auto square = _grid->getSquare(index % 3, index / 3);
-    if (!square || !square->bit()) {
-        return nullptr;
-    }
-    return square->bit()->getOwner();
+    releaseBits();
+    _board.reset();
 }
 
 Player* TicTacToe::checkForWinner()
 {
-    static const int kWinningTriples[8][3] =  { {0,1,2}, {3,4,5}, {6,7,8},  // rows
-                                                {0,3,6}, {1,4,7}, {2,5,8},  // cols
-                                                {0,4,8}, {2,4,6} };         // diagonals
-    for( int i=0; i<8; i++ ) {
-        const int *triple = kWinningTriples[i];
-        Player *player = ownerAt(triple[0]);
-        if( player && player == ownerAt(triple[1]) && player == ownerAt(triple[2]) )
-            return player;
-    }
-    return nullptr;
+    int winner = _board.winner();
+    return winner < 0 ? nullptr : getPlayerAt(winner);
 }
 
 bool TicTacToe::checkForDraw()
 {
-    bool isDraw = true;
     // check to see if the board is full
-    _grid->forEachSquare([&isDraw](ChessSquare* square, int x, int y) {
-        if (!square->bit()) {
-            isDraw = false;
-        }
-    });
-    return isDraw;
+    return _board.isFull();
 }
 
 //
@@ -128,16 +134,9 @@ std::string TicTacToe::initialStateString()
 // this still needs to be tied into imguis init and shutdown
 // we will read the state string and store it in each turn object
 //
-std::string TicTacToe::stateString()
+std::string TicTacToe::buildStateString()
 {
-    std::string s = "000000000";
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        Bit *bit = square->bit();
-        if (bit) {
-            s[y * 3 + x] = std::to_string(bit->getOwner()->playerNumber()+1)[0];
-        }
-    });
-    return s;
+    return _board.stateString();
 }
 
 //
@@ -146,15 +145,8 @@ std::string TicTacToe::stateString()
 //
 void TicTacToe::setStateString(const std::string &s)
 {
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y*3 + x;
-        int playerNumber = s[index] - '0';
-        if (playerNumber) {
-            square->setBit( PieceForPlayer(playerNumber-1) );
-        } else {
-            square->setBit( nullptr );
-        }
-    });
+    _board.setStateString(s);
+    syncGrid();
 }
 
 
@@ -163,22 +155,19 @@ void TicTacToe::setStateString(const std::string &s)
 //
 void TicTacToe::updateAI() 
 {
-    BitHolder* bestMove = nullptr;
-    std::string state = stateString();
-
-    // Traverse all cells, evaluate minimax function for all empty cells
-    _grid->forEachSquare([&](ChessSquare* square, int x, int y) {
-        int index = y * 3 + x;
-        // Check if cell is empty
-        if (state[index] == '0') {
-            bestMove = square;
-        }
-    });
+    // perfect play is a single table lookup
+    int index = TicTacToeSolver::bestMove(_board);
+    if (index < 0) {
+        return;
+    }
 
+    // no search to speak of, the stats say where the move came from and what it leads to
+    _searchStats = SearchStats();
+    _searchStats.source = "table";
+    _searchStats.score = (int)TicTacToeSolver::outcome(_board) - (int)TicTacToeSolver::OUTCOME_DRAW;
+    _searchStats.pv.push_back(std::to_string(index));
+    publishSearchStats();
 
     // Make the best move
-    if(bestMove) {
-        if (actionForEmptyHolder(*bestMove)) {
-        }
-    }
+    actionForEmptyHolder(*_grid->getSquare(index % 3, index / 3));
 }
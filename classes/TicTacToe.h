@@ -1,5 +1,6 @@
 #pragma once
 #include "Game.h"
+#include "TicTacToeBoard.h"
 
 //
 // the classic game of tic tac toe
@@ -12,7 +13,7 @@ class TicTacToe : public Game
 {
 public:
     TicTacToe();
-    ~TicTacToe();
+    ~TicTacToe() override;
 
     // set up the board
     void        setUpBoard() override;
@@ -20,7 +21,6 @@ public:
     Player*     checkForWinner() override;
     bool        checkForDraw() override;
     std::string initialStateString() override;
-    std::string stateString() override;
     void        setStateString(const std::string &s) override;
     bool        actionForEmptyHolder(BitHolder &holder) override;
     bool        canBitMoveFrom(Bit &bit, BitHolder &src) override;
@@ -30,11 +30,15 @@ public:
 	void        updateAI() override;
     bool        gameHasAI() override { return true; }
     Grid* getGrid() override { return _grid; }
+protected:
+    std::string buildStateString() override;
+    bool        replayMove(int move) override;
 private:
     Bit *       PieceForPlayer(const int playerNumber);
-    Player*     ownerAt(int index ) const;
-    int         negamax(std::string& state, int depth, int playerColor);
+    void        syncGrid();
 
     Grid*       _grid;
+    // the rules and state live here, the grid is only a view of it
+    TicTacToeBoard _board;
 };
 
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//
+// tic-tac-toe rules on two 9-bit masks, with no grid or sprites attached
+// square index is y * 3 + x, the same order as the game's state string
+// player 0 is X ('1' in state strings) and moves first
+//
+// index() reads the state string as a base 3 number, least significant digit first,
+// so every position has its own slot in a 3^9 table
+//
+class TicTacToeBoard
+{
+public:
+    static const int NUM_SQUARES = 9;
+    static const int NUM_INDICES = 19683;   // 3^9
+
+    TicTacToeBoard() { reset(); }
+
+    void reset()
+    {
+        _boards[0] = 0;
+        _boards[1] = 0;
+        _moves = 0;
+        _index = 0;
+    }
+
+    int         currentPlayer() const { return _moves & 1; }
+    int         moves() const { return _moves; }
+    int         index() const { return _index; }
+    uint16_t    board(int player) const { return _boards[player]; }
+    uint16_t    emptySquares() const { return (uint16_t)(~(_boards[0] | _boards[1]) & 0x1ff); }
+    bool        isFull() const { return _moves == NUM_SQUARES; }
+    bool        canPlay(int square) const { return (emptySquares() >> square) & 1; }
+
+    void play(int square)
+    {
+        _index += ((_moves & 1) + 1) * POWERS_OF_3[square];
+        _boards[_moves & 1] |= (uint16_t)(1 << square);
+        _moves++;
+    }
+
+    void undo(int square)
+    {
+        _moves--;
+        _boards[_moves & 1] &= (uint16_t)~(1 << square);
+        _index -= ((_moves & 1) + 1) * POWERS_OF_3[square];
+    }
+
+    // 0 or 1 for a completed line, -1 if nobody has won
+    int winner() const
+    {
+        if (hasThreeInARow(_boards[0])) return 0;
+        if (hasThreeInARow(_boards[1])) return 1;
+        return -1;
+    }
+
+    bool isGameOver() const { return isFull() || winner() >= 0; }
+
+    static bool hasThreeInARow(uint16_t board)
+    {
+        static const uint16_t LINES[8] = {
+            0x007, 0x038, 0x1c0,    // rows
+            0x049, 0x092, 0x124,    // cols
+            0x111, 0x054            // diagonals
+        };
+        for (int i = 0; i < 8; i++) {
+            if ((board & LINES[i]) == LINES[i]) return true;
+        }
+        return false;
+    }
+
+    // '0'/'1'/'2' strings, the player to move follows from the number of pieces
+    bool setStateString(const std::string &s)
+    {
+        reset();
+        if (s.length() < (size_t)NUM_SQUARES) return false;
+        for (int i = 0; i < NUM_SQUARES; i++) {
+            if (s[i] == '1' || s[i] == '2') {
+                _boards[s[i] - '1'] |= (uint16_t)(1 << i);
+                _index += (s[i] - '0') * POWERS_OF_3[i];
+                _moves++;
+            }
+        }
+        return true;
+    }
+
+    std::string stateString() const
+    {
+        std::string state(NUM_SQUARES, '0');
+        for (int i = 0; i < NUM_SQUARES; i++) {
+            if ((_boards[0] >> i) & 1) state[i] = '1';
+            else if ((_boards[1] >> i) & 1) state[i] = '2';
+        }
+        return state;
+    }
+
+private:
+    static constexpr int POWERS_OF_3[NUM_SQUARES] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+    uint16_t    _boards[2];
+    int         _moves;
+    int         _index;
+};
@@ -0,0 +1,74 @@
+#include "TicTacToeSolver.h"
+
+static const int8_t UNSOLVED = INT8_MIN;
+
+//
+// negamax over every reachable position, memoized by index
+// a win scores 10 minus the pieces on the board at the end, so quicker wins score higher
+//
+static int solve(TicTacToeBoard &board, int8_t *scores, uint8_t *table)
+{
+    int index = board.index();
+    if (scores[index] != UNSOLVED) {
+        return scores[index];
+    }
+
+    int best;
+    int bestSquare = 0xf;
+    if (board.winner() >= 0) {
+        // the player who just moved has won
+        best = -(10 - board.moves());
+    } else if (board.isFull()) {
+        best = 0;
+    } else {
+        best = -100;
+        for (int square = 0; square < TicTacToeBoard::NUM_SQUARES; square++) {
+            if (!board.canPlay(square)) continue;
+            board.play(square);
+            int score = -solve(board, scores, table);
+            board.undo(square);
+            if (score > best) {
+                best = score;
+                bestSquare = square;
+            }
+        }
+    }
+
+    TicTacToeSolver::Outcome outcome = TicTacToeSolver::OUTCOME_DRAW;
+    if (best > 0) outcome = TicTacToeSolver::OUTCOME_WIN;
+    else if (best < 0) outcome = TicTacToeSolver::OUTCOME_LOSS;
+
+    scores[index] = (int8_t)best;
+    table[index] = (uint8_t)((bestSquare << 4) | outcome);
+    return best;
+}
+
+const uint8_t *TicTacToeSolver::table()
+{
+    // solved on first use, function statics are initialized once even across threads
+    static const struct Table {
+        uint8_t entries[TicTacToeBoard::NUM_INDICES];
+
+        Table()
+        {
+            static int8_t scores[TicTacToeBoard::NUM_INDICES];
+            for (int i = 0; i < TicTacToeBoard::NUM_INDICES; i++) {
+                scores[i] = UNSOLVED;
+                entries[i] = (uint8_t)((NO_MOVE << 4) | OUTCOME_UNREACHABLE);
+            }
+            TicTacToeBoard board;
+            solve(board, scores, entries);
+        }
+    } solved;
+    return solved.entries;
+}
+
+int TicTacToeSolver::numReachable()
+{
+    const uint8_t *entries = table();
+    int count = 0;
+    for (int i = 0; i < TicTacToeBoard::NUM_INDICES; i++) {
+        if ((entries[i] & 0x3) != OUTCOME_UNREACHABLE) count++;
+    }
+    return count;
+}
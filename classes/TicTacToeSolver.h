@@ -0,0 +1,90 @@
+#pragma once
+#include "TicTacToeBoard.h"
+#include "Search.h"
+#include <cstdint>
+
+//
+// perfect play for tic-tac-toe from a table solved once, the first time it is used
+// every position reachable from the empty board has a slot, found by
+// TicTacToeBoard::index(), holding the best move and the result with best play
+//
+// among moves with the same result the quickest win or the slowest loss is kept
+//
+class TicTacToeSolver
+{
+public:
+    // result for the player to move
+    enum Outcome : uint8_t {
+        OUTCOME_LOSS = 0,
+        OUTCOME_DRAW,
+        OUTCOME_WIN,
+        OUTCOME_UNREACHABLE     // can't come up in a real game
+    };
+
+    // best square for the player to move, -1 once the game is over or the position can't happen
+    static int bestMove(const TicTacToeBoard &board)
+    {
+        int move = entry(board.index()) >> 4;
+        return move == NO_MOVE ? -1 : move;
+    }
+    static Outcome  outcome(const TicTacToeBoard &board) { return (Outcome)(entry(board.index()) & 0x3); }
+
+    // number of positions reachable from the empty board, terminal ones included
+    static int      numReachable();
+
+private:
+    static const uint8_t NO_MOVE = 0xf;
+
+    // best move in the high four bits, outcome in the low two
+    static uint8_t  entry(int index) { return table()[index]; }
+    static const uint8_t *table();
+};
+
+//
+// a TicTacToeBoard as Search<> sees it
+// the game plays from the solved table, the state is there so tic-tac-toe can be
+// searched like every other game, and a full depth search has to agree with the table
+//
+struct TicTacToeSearchState
+{
+    using Move = int;   // the square
+
+    static const int MAX_MOVES = TicTacToeBoard::NUM_SQUARES;
+    static const int MOVE_IDS = TicTacToeBoard::NUM_SQUARES;
+    static const int WIN_SCORE = 1000;
+
+    TicTacToeBoard board;
+
+    int generateMoves(Move *moves) const
+    {
+        int count = 0;
+        for (int square = 0; square < TicTacToeBoard::NUM_SQUARES; square++) {
+            if (board.canPlay(square)) moves[count++] = square;
+        }
+        return count;
+    }
+    void        makeMove(Move &square) { board.play(square); }
+    void        unmakeMove(const Move &square) { board.undo(square); }
+    // the player who just moved completed a line, or the board filled up for a draw
+    bool isTerminal(int ply, int &score) const
+    {
+        if (board.winner() >= 0) {
+            score = -(WIN_SCORE - ply);
+            return true;
+        }
+        if (board.isFull()) {
+            score = 0;
+            return true;
+        }
+        return false;
+    }
+    bool        isQuiet() const { return true; }
+    int         evaluate() const { return 0; }
+    uint64_t    key() const { return (uint64_t)board.index() * 0x9e3779b97f4a7c15ULL; }
+    int         moveId(const Move &square) const { return square; }
+    // centre, then corners, then edges
+    int         orderScore(const Move &square, int) const { return square == 4 ? 2 : (square & 1) ? 0 : 1; }
+    int         extension(const Move &) const { return 0; }
+    std::string moveName(const Move &square) const { return std::to_string(square); }
+};
+static_assert(SearchState<TicTacToeSearchState>);
@@ -0,0 +1,102 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable()
+{
+    _numEntries = 0;
+    _megabytes = 0;
+    _shift = 64;
+    _generation = 0;
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+    if (megabytes < 1) megabytes = 1;
+    if (megabytes == _megabytes && _slots) return;
+
+    // largest power of two number of entries that fits in the budget
+    size_t maxEntries = (megabytes * 1024 * 1024) / sizeof(Slot);
+    size_t count = 1;
+    int bits = 0;
+    while (count * 2 <= maxEntries) {
+        count *= 2;
+        bits++;
+    }
+
+    _slots.reset(new Slot[count]);
+    _numEntries = count;
+    _megabytes = megabytes;
+    _shift = 64 - bits;
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < _numEntries; i++) {
+        _slots[i].check.store(0, std::memory_order_relaxed);
+        _slots[i].data.store(0, std::memory_order_relaxed);
+    }
+    _generation = 0;
+}
+
+uint64_t TranspositionTable::pack(const Entry &entry)
+{
+    return (uint64_t)(uint16_t)entry.score
+        | ((uint64_t)(uint16_t)entry.move << 16)
+        | ((uint64_t)(uint8_t)entry.depth << 32)
+        | ((uint64_t)entry.bound << 40)
+        | ((uint64_t)entry.generation << 48);
+}
+
+TranspositionTable::Entry TranspositionTable::unpack(uint64_t key, uint64_t data)
+{
+    Entry entry;
+    entry.key = key;
+    entry.score = (int16_t)(uint16_t)data;
+    entry.move = (int16_t)(uint16_t)(data >> 16);
+    entry.depth = (int8_t)(uint8_t)(data >> 32);
+    entry.bound = (uint8_t)(data >> 40);
+    entry.generation = (uint8_t)(data >> 48);
+    return entry;
+}
+
+bool TranspositionTable::probe(uint64_t key, Entry &entry) const
+{
+    if (!_slots) return false;
+
+    const Slot &slot = _slots[indexFor(key)];
+    uint64_t data = slot.data.load(std::memory_order_relaxed);
+    uint64_t check = slot.check.load(std::memory_order_relaxed);
+    if ((check ^ data) != key) return false;
+
+    entry = unpack(key, data);
+    return entry.bound != BOUND_NONE;
+}
+
+//
+// depth-preferred replacement: a slot written during this search is only given up
+// to an equal or deeper result, anything from an older search is always replaced
+//
+void TranspositionTable::store(uint64_t key, int depth, Bound bound, int score, int move)
+{
+    if (!_slots) return;
+
+    Slot &slot = _slots[indexFor(key)];
+    uint64_t oldData = slot.data.load(std::memory_order_relaxed);
+    uint64_t oldKey = slot.check.load(std::memory_order_relaxed) ^ oldData;
+    Entry old = unpack(oldKey, oldData);
+    if (old.bound != BOUND_NONE && old.generation == _generation && oldKey != key && depth < old.depth) {
+        return;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.score = (int16_t)score;
+    entry.move = (int16_t)move;
+    entry.depth = (int8_t)depth;
+    entry.bound = bound;
+    entry.generation = _generation;
+
+    uint64_t data = pack(entry);
+    slot.check.store(key ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
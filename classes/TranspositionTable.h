@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+
+//
+// fixed size, power-of-two transposition table shared by the AI searches
+// one entry per slot, indexed by a mixed position key; the full key is kept in
+// the entry so a slot collision never returns another position's score
+//
+// the table can be shared by several search threads without locking: each slot
+// keeps its packed data and the key xor'ed with that data, so a slot torn by two
+// threads writing at once simply fails the key check on the next probe
+//
+class TranspositionTable
+{
+public:
+    enum Bound : uint8_t {
+        BOUND_NONE = 0,
+        BOUND_EXACT,    // score is the true value of the position
+        BOUND_LOWER,    // search failed high, the value is at least score
+        BOUND_UPPER     // search failed low, the value is at most score
+    };
+
+    struct Entry {
+        uint64_t    key;
+        int16_t     score;
+        int16_t     move;
+        int8_t      depth;
+        uint8_t     bound;
+        uint8_t     generation;
+    };
+
+    TranspositionTable();
+
+    // size the table to fit within the budget, rounded down to a power of two entries
+    // not thread safe, only call while no search is running
+    void        resize(size_t megabytes);
+    void        clear();
+    // call once per root search so entries left over from earlier moves can be replaced
+    void        newSearch() { _generation++; }
+
+    bool        probe(uint64_t key, Entry &entry) const;
+    void        store(uint64_t key, int depth, Bound bound, int score, int move);
+
+    size_t      sizeInMegabytes() const { return _megabytes; }
+    size_t      numEntries() const { return _numEntries; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t>   check;  // key ^ data
+        std::atomic<uint64_t>   data;
+    };
+
+    size_t      indexFor(uint64_t key) const { return (size_t)((key * 0x9E3779B97F4A7C15ULL) >> _shift); }
+
+    static uint64_t pack(const Entry &entry);
+    static Entry    unpack(uint64_t key, uint64_t data);
+
+    std::unique_ptr<Slot[]> _slots;
+    size_t                  _numEntries;
+    size_t                  _megabytes;
+    int                     _shift;
+    uint8_t                 _generation;
+};
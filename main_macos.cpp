@@ -173,6 +173,7 @@ int main(int, char**)
 #endif
 
     // Cleanup
+    ClassGame::GameShutDown();
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
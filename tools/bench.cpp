@@ -0,0 +1,367 @@
+//
+// micro-benchmarks for the hot paths under the games
+// times the connect 4 search on a fixed set of positions, state string round trips and
+// winner checks for every game, othello move generation and the grid visitors, prints a
+// table and writes the same numbers as JSON so two runs can be diffed
+//
+// usage: bench [--depth N] [--iterations N] [--seed N] [--out FILE]
+//
+// the search runs on one thread with a cleared table per position, so its node counts
+// only change when the search itself does; everything else reports nanoseconds per call
+// averaged over --iterations calls spread across a set of random positions
+//
+#include "../classes/Connect4Position.h"
+#include "../classes/Connect4AI.h"
+#include "../classes/OthelloBoard.h"
+#include "../classes/CheckersBoard.h"
+#include "../classes/TicTacToeBoard.h"
+#include "../classes/Grid.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+static const int NUM_RANDOM_POSITIONS = 256;
+
+// columns played from the empty board, from the opening to crowded middle games,
+// all undecided and none with a win on the board for the side to move
+static const char *CONNECT4_POSITIONS[] = {
+    "",
+    "3",
+    "56",
+    "6114",
+    "320333",
+    "64211251",
+    "5425522465",
+    "342454403360",
+    "51454321501154",
+    "3463255506613643",
+};
+
+struct BenchResult
+{
+    std::string name;
+    uint64_t iterations;
+    double nsPerOp;
+    // search benchmarks only
+    uint64_t nodes;
+    double nodesPerSecond;
+};
+
+// keeps the optimizer from dropping the work being timed
+static volatile uint64_t sink;
+
+template <typename F>
+static double timeNs(uint64_t iterations, F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < iterations; i++) {
+        total += f(i);
+    }
+    sink = sink + total;
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (double)iterations;
+}
+
+//
+// random positions for each game, none of them already over
+//
+static std::vector<Connect4Position> randomConnect4(std::mt19937 &rng)
+{
+    std::vector<Connect4Position> positions;
+    while (positions.size() < NUM_RANDOM_POSITIONS) {
+        Connect4Position position;
+        int plies = (int)(rng() % 30);
+        for (int ply = 0; ply < plies; ply++) {
+            int cols[Connect4Position::WIDTH];
+            int count = 0;
+            for (int col = 0; col < Connect4Position::WIDTH; col++) {
+                if (position.canPlay(col) && !position.isWinningMove(col)) cols[count++] = col;
+            }
+            if (count == 0) break;
+            position.play(cols[rng() % count]);
+        }
+        positions.push_back(position);
+    }
+    return positions;
+}
+
+static std::vector<OthelloBoard> randomOthello(std::mt19937 &rng)
+{
+    std::vector<OthelloBoard> boards;
+    while (boards.size() < NUM_RANDOM_POSITIONS) {
+        OthelloBoard board;
+        int plies = (int)(rng() % 50);
+        for (int ply = 0; ply < plies && !board.isGameOver(); ply++) {
+            uint64_t moves = board.legalMoves();
+            if (!moves) {
+                board.pass();
+                continue;
+            }
+            int pick = (int)(rng() % std::popcount(moves));
+            while (pick--) moves &= moves - 1;
+            board.play(std::countr_zero(moves));
+        }
+        boards.push_back(board);
+    }
+    return boards;
+}
+
+static std::vector<CheckersBoard> randomCheckers(std::mt19937 &rng)
+{
+    std::vector<CheckersBoard> boards;
+    while (boards.size() < NUM_RANDOM_POSITIONS) {
+        CheckersBoard board;
+        int plies = (int)(rng() % 60);
+        for (int ply = 0; ply < plies; ply++) {
+            CheckersMove moves[CheckersBoard::MAX_MOVES];
+            int count = board.generateMoves(moves);
+            if (count == 0) break;
+            board.makeMove(moves[rng() % count]);
+        }
+        boards.push_back(board);
+    }
+    return boards;
+}
+
+static std::vector<TicTacToeBoard> randomTicTacToe(std::mt19937 &rng)
+{
+    std::vector<TicTacToeBoard> boards;
+    while (boards.size() < NUM_RANDOM_POSITIONS) {
+        TicTacToeBoard board;
+        int plies = (int)(rng() % 8);
+        for (int ply = 0; ply < plies && !board.isGameOver(); ply++) {
+            int squares[TicTacToeBoard::NUM_SQUARES];
+            int count = 0;
+            for (int square = 0; square < TicTacToeBoard::NUM_SQUARES; square++) {
+                if (board.canPlay(square)) squares[count++] = square;
+            }
+            board.play(squares[rng() % count]);
+        }
+        boards.push_back(board);
+    }
+    return boards;
+}
+
+//
+// state string out, back in on a scratch board and out of that again; what is read
+// back goes into the result, so the compiler can't drop the board being set up
+//
+template <typename Board>
+static BenchResult benchRoundTrip(const char *name, const std::vector<Board> &boards, uint64_t iterations)
+{
+    Board scratch;
+    double ns = timeNs(iterations, [&](uint64_t i) {
+        std::string state = boards[i % boards.size()].stateString();
+        scratch.setStateString(state);
+        return (uint64_t)(scratch.stateString() == state);
+    });
+    return {name, iterations, ns, 0, 0.0};
+}
+
+static void printUsage()
+{
+    printf("usage: bench [--depth N] [--iterations N] [--seed N] [--out FILE]\n");
+}
+
+static void writeJson(FILE *file, int depth, const std::vector<BenchResult> &results)
+{
+    fprintf(file, "{\n  \"connect4_depth\": %d,\n  \"results\": [\n", depth);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &result = results[i];
+        fprintf(file, "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.2f",
+                result.name.c_str(), (unsigned long long)result.iterations, result.nsPerOp);
+        if (result.nodes) {
+            fprintf(file, ", \"nodes\": %llu, \"nodes_per_second\": %.0f",
+                    (unsigned long long)result.nodes, result.nodesPerSecond);
+        }
+        fprintf(file, "}%s\n", i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+}
+
+int main(int argc, char **argv)
+{
+    int depth = 12;
+    uint64_t iterations = 1000000;
+    unsigned int seed = 1;
+    std::string outPath = "bench.json";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--help") == 0) {
+            printUsage();
+            return 0;
+        }
+        if (!value) {
+            printUsage();
+            return 1;
+        }
+        i++;
+        if (strcmp(arg, "--depth") == 0) {
+            depth = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--iterations") == 0) {
+            iterations = (uint64_t)std::max(1LL, atoll(value));
+        } else if (strcmp(arg, "--seed") == 0) {
+            seed = (unsigned int)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--out") == 0) {
+            outPath = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    std::vector<BenchResult> results;
+
+    // connect 4 search, one result per position and a total
+    {
+        Connect4AI engine;
+        engine.setThreads(1);
+        engine.setTableSize(64);
+        uint64_t totalNodes = 0;
+        double totalSeconds = 0.0;
+        int count = 0;
+        for (const char *moves : CONNECT4_POSITIONS) {
+            Connect4Position position;
+            bool legal = true;
+            for (const char *c = moves; *c && legal; c++) {
+                int col = *c - '0';
+                legal = col >= 0 && col < Connect4Position::WIDTH && position.canPlay(col) && !position.isWinningMove(col);
+                if (legal) position.play(col);
+            }
+            if (!legal) {
+                fprintf(stderr, "skipping connect 4 position %s, it isn't a game in progress\n", moves);
+                continue;
+            }
+            engine.clearTable();
+            int score = 0;
+            auto start = std::chrono::steady_clock::now();
+            engine.search(position, depth, 0, score);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            std::string name = std::string("connect4_search/") + (*moves ? moves : "start");
+            results.push_back({name, 1, seconds * 1e9, engine.nodes(), engine.nodes() / std::max(seconds, 1e-9)});
+            totalNodes += engine.nodes();
+            totalSeconds += seconds;
+            count++;
+        }
+        results.push_back({"connect4_search/total", (uint64_t)count, totalSeconds * 1e9 / count,
+                           totalNodes, totalNodes / std::max(totalSeconds, 1e-9)});
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<Connect4Position> connect4 = randomConnect4(rng);
+    std::vector<OthelloBoard> othello = randomOthello(rng);
+    std::vector<CheckersBoard> checkers = randomCheckers(rng);
+    std::vector<TicTacToeBoard> tictactoe = randomTicTacToe(rng);
+
+    results.push_back(benchRoundTrip("state_roundtrip/connect4", connect4, iterations));
+    results.push_back(benchRoundTrip("state_roundtrip/othello", othello, iterations));
+    results.push_back(benchRoundTrip("state_roundtrip/checkers", checkers, iterations));
+    results.push_back(benchRoundTrip("state_roundtrip/tictactoe", tictactoe, iterations));
+
+    // what each game's checkForWinner asks its core; connect 4 only looks at the lines
+    // through each disc as it drops, here the top disc of whoever moved last
+    std::vector<uint64_t> connect4Drops;
+    for (const Connect4Position &position : connect4) {
+        uint64_t drop = 0;
+        int player = (position.moves() + 1) & 1;
+        for (int col = 0; col < Connect4Position::WIDTH && !drop; col++) {
+            int height = position.height(col);
+            if (height == 0) continue;
+            uint64_t cell = Connect4Position::cellMask(col, height - 1);
+            if (position.board(player) & cell) drop = cell;
+        }
+        connect4Drops.push_back(drop);
+    }
+    results.push_back({"winner/connect4", iterations, timeNs(iterations, [&](uint64_t i) {
+        size_t n = i % connect4.size();
+        int player = (connect4[n].moves() + 1) & 1;
+        return (uint64_t)Connect4Position::connectsFour(connect4[n].board(player), connect4Drops[n]);
+    }), 0, 0.0});
+    // the whole board for both players, as the game used to ask after every move
+    results.push_back({"winner/connect4_full_scan", iterations, timeNs(iterations, [&](uint64_t i) {
+        const Connect4Position &position = connect4[i % connect4.size()];
+        return (uint64_t)(Connect4Position::hasFourInARow(position.board(0)) + Connect4Position::hasFourInARow(position.board(1)));
+    }), 0, 0.0});
+    results.push_back({"winner/othello", iterations, timeNs(iterations, [&](uint64_t i) {
+        return (uint64_t)othello[i % othello.size()].isGameOver();
+    }), 0, 0.0});
+    results.push_back({"winner/checkers", iterations, timeNs(iterations, [&](uint64_t i) {
+        return (uint64_t)(checkers[i % checkers.size()].winner() + 1);
+    }), 0, 0.0});
+    results.push_back({"winner/tictactoe", iterations, timeNs(iterations, [&](uint64_t i) {
+        return (uint64_t)(tictactoe[i % tictactoe.size()].winner() + 1);
+    }), 0, 0.0});
+
+    // othello move generation, and making and taking back the first legal move
+    results.push_back({"othello/legal_moves", iterations, timeNs(iterations, [&](uint64_t i) {
+        return othello[i % othello.size()].legalMoves();
+    }), 0, 0.0});
+    results.push_back({"othello/play_undo", iterations, timeNs(iterations, [&](uint64_t i) {
+        OthelloBoard &board = othello[i % othello.size()];
+        uint64_t moves = board.legalMoves();
+        if (!moves) return (uint64_t)0;
+        int square = std::countr_zero(moves);
+        uint64_t flips = board.play(square);
+        board.undo(square, flips);
+        return flips;
+    }), 0, 0.0});
+
+    // grid visitors and serialization on an 8x8 board with every other square filled
+    {
+        Grid grid(8, 8);
+        std::vector<Bit> bits(32);
+        int placed = 0;
+        grid.forEachSquare([&](ChessSquare *square, int x, int y) {
+            if ((x + y) & 1) {
+                bits[placed].setGameTag(1 + (placed & 1));
+                square->setBit(&bits[placed++]);
+            }
+        });
+        uint64_t gridIterations = std::max<uint64_t>(1, iterations / 10);
+        results.push_back({"grid/for_each_square", gridIterations, timeNs(gridIterations, [&](uint64_t) {
+            uint64_t count = 0;
+            grid.forEachSquare([&](ChessSquare *square, int x, int y) { count += square->bit() != nullptr; });
+            return count;
+        }), 0, 0.0});
+        results.push_back({"grid/for_each_enabled_square", gridIterations, timeNs(gridIterations, [&](uint64_t) {
+            uint64_t count = 0;
+            grid.forEachEnabledSquare([&](ChessSquare *square, int x, int y) { count += square->bit() != nullptr; });
+            return count;
+        }), 0, 0.0});
+        results.push_back({"grid/state_string", gridIterations, timeNs(gridIterations, [&](uint64_t) {
+            return (uint64_t)grid.getStateString().size();
+        }), 0, 0.0});
+        // the bits belong to the vector, not the squares
+        grid.forEachSquare([](ChessSquare *square, int x, int y) { square->forgetBit(); });
+    }
+
+    printf("%-40s %14s %14s %14s\n", "benchmark", "ns/op", "nodes", "nodes/s");
+    for (const BenchResult &result : results) {
+        if (result.nodes) {
+            printf("%-40s %14.1f %14llu %14.0f\n", result.name.c_str(), result.nsPerOp,
+                   (unsigned long long)result.nodes, result.nodesPerSecond);
+        } else {
+            printf("%-40s %14.1f\n", result.name.c_str(), result.nsPerOp);
+        }
+    }
+
+    FILE *file = std::fopen(outPath.c_str(), "w");
+    if (!file) {
+        fprintf(stderr, "couldn't write %s\n", outPath.c_str());
+        return 1;
+    }
+    writeJson(file, depth, results);
+    std::fclose(file);
+    printf("wrote %s\n", outPath.c_str());
+    return 0;
+}
@@ -0,0 +1,155 @@
+//
+// connect 4 opening book generator
+// searches every position reachable in the first few moves with the regular engine
+// and writes the best move of each to a book file Connect4 maps at run time
+//
+// usage: connect4book [--ply N] [--depth N] [--time MS] [--tt MB] [--threads N] [--out FILE]
+//
+// positions that are mirror images of each other are searched once, and positions
+// where the game is already over are left out
+//
+#include "../classes/Connect4Position.h"
+#include "../classes/Connect4AI.h"
+#include "../classes/Connect4Book.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+struct BookSettings
+{
+    int maxPly = 6;
+    int maxDepth = 42;
+    int timeMs = 1000;
+    int tableMB = 64;
+};
+
+//
+// every position up to maxPly, one of each mirrored pair, the smaller key's side kept
+//
+static void collectPositions(Connect4Position &position, int maxPly, std::unordered_set<uint64_t> &seen,
+                             std::vector<Connect4Position> &positions)
+{
+    uint64_t key = position.key();
+    uint64_t canonical = std::min(key, Connect4Position::mirrorKey(key));
+    if (!seen.insert(canonical).second) {
+        return;
+    }
+    positions.push_back(position);
+    if (position.moves() >= maxPly) {
+        return;
+    }
+
+    for (int col = 0; col < Connect4Position::WIDTH; col++) {
+        if (!position.canPlay(col) || position.isWinningMove(col)) continue;
+        position.play(col);
+        collectPositions(position, maxPly, seen, positions);
+        position.undo(col);
+    }
+}
+
+static void printUsage()
+{
+    printf("usage: connect4book [--ply N] [--depth N] [--time MS] [--tt MB] [--threads N] [--out FILE]\n");
+}
+
+int main(int argc, char **argv)
+{
+    BookSettings settings;
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    std::string outPath = "resources/connect4.book";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--help") == 0) {
+            printUsage();
+            return 0;
+        }
+        if (!value) {
+            printUsage();
+            return 1;
+        }
+        i++;
+        if (strcmp(arg, "--ply") == 0) {
+            settings.maxPly = std::min(std::max(0, atoi(value)), Connect4Position::NUM_CELLS - 1);
+        } else if (strcmp(arg, "--depth") == 0) {
+            settings.maxDepth = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--time") == 0) {
+            settings.timeMs = std::max(0, atoi(value));
+        } else if (strcmp(arg, "--tt") == 0) {
+            settings.tableMB = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--threads") == 0) {
+            numThreads = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--out") == 0) {
+            outPath = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    Connect4Position root;
+    std::unordered_set<uint64_t> seen;
+    std::vector<Connect4Position> positions;
+    collectPositions(root, settings.maxPly, seen, positions);
+    fprintf(stderr, "%zu positions up to ply %d\n", positions.size(), settings.maxPly);
+
+    std::vector<uint64_t> entries(positions.size());
+    std::atomic<size_t> next(0);
+    std::atomic<size_t> done(0);
+    std::mutex progressMutex;
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        // every worker owns its engine and table, one search thread each
+        Connect4AI engine;
+        engine.setThreads(1);
+        engine.setTableSize(settings.tableMB);
+
+        for (size_t i = next++; i < positions.size(); i = next++) {
+            const Connect4Position &position = positions[i];
+            int score = 0;
+            int col = engine.search(position, settings.maxDepth, settings.timeMs, score);
+
+            // store the move for whichever of the pair has the smaller key
+            uint64_t key = position.key();
+            uint64_t mirrored = Connect4Position::mirrorKey(key);
+            if (mirrored < key) {
+                key = mirrored;
+                col = Connect4Position::WIDTH - 1 - col;
+            }
+            entries[i] = Connect4Book::packEntry(key, col, score);
+
+            size_t count = ++done;
+            if (count % 100 == 0) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                fprintf(stderr, "%zu/%zu positions\n", count, positions.size());
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    if (!Connect4Book::write(outPath, settings.maxPly, entries)) {
+        fprintf(stderr, "couldn't write %s\n", outPath.c_str());
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("wrote %zu positions to %s in %.1fs\n", entries.size(), outPath.c_str(), elapsed);
+    return 0;
+}
@@ -0,0 +1,146 @@
+//
+// connect 4 endgame table generator
+// plays random games down to a number of empty cells, then solves every position that
+// can follow from there exactly and writes the values to a table Connect4AI probes
+//
+// usage: connect4endgame [--empties N] [--games N] [--seed N] [--out FILE]
+//
+// a game that is over before it gets that far is thrown away and played again, so the
+// table covers --games late positions and everything that can follow them
+//
+#include "../classes/Connect4Position.h"
+#include "../classes/Connect4EndgameDB.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const int MAX_ATTEMPTS_PER_GAME = 1000;
+
+//
+// exact value of the position for the player to move, memoized on the mirrored key
+// every non-terminal position the search passes through goes into the table
+//
+static int solve(Connect4Position &position, std::unordered_map<uint64_t, int8_t> &values)
+{
+    if (position.isFull()) {
+        return Connect4EndgameDB::VALUE_DRAW;
+    }
+    uint64_t key = position.key();
+    key = std::min(key, Connect4Position::mirrorKey(key));
+    auto it = values.find(key);
+    if (it != values.end()) {
+        return it->second;
+    }
+
+    int best = Connect4EndgameDB::VALUE_LOSS;
+    for (int col = 0; col < Connect4Position::WIDTH && best < Connect4EndgameDB::VALUE_WIN; col++) {
+        if (!position.canPlay(col)) continue;
+        if (position.isWinningMove(col)) {
+            best = Connect4EndgameDB::VALUE_WIN;
+            break;
+        }
+        position.play(col);
+        best = std::max(best, -solve(position, values));
+        position.undo(col);
+    }
+
+    values[key] = (int8_t)best;
+    return best;
+}
+
+//
+// random moves, never an immediate win, until maxEmpties cells are left
+// false if the game ends or leaves no such move first
+//
+static bool playDown(Connect4Position &position, int maxEmpties, std::mt19937 &rng)
+{
+    while (Connect4Position::NUM_CELLS - position.moves() > maxEmpties) {
+        int cols[Connect4Position::WIDTH];
+        int count = 0;
+        for (int col = 0; col < Connect4Position::WIDTH; col++) {
+            if (position.canPlay(col) && !position.isWinningMove(col)) cols[count++] = col;
+        }
+        if (count == 0) return false;
+        position.play(cols[rng() % count]);
+    }
+    return true;
+}
+
+static void printUsage()
+{
+    printf("usage: connect4endgame [--empties N] [--games N] [--seed N] [--out FILE]\n");
+}
+
+int main(int argc, char **argv)
+{
+    int maxEmpties = 12;
+    int numGames = 100;
+    unsigned int seed = 1;
+    std::string outPath = "resources/connect4.endgame";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--help") == 0) {
+            printUsage();
+            return 0;
+        }
+        if (!value) {
+            printUsage();
+            return 1;
+        }
+        i++;
+        if (strcmp(arg, "--empties") == 0) {
+            maxEmpties = std::min(std::max(1, atoi(value)), (int)Connect4Position::NUM_CELLS);
+        } else if (strcmp(arg, "--games") == 0) {
+            numGames = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--seed") == 0) {
+            seed = (unsigned int)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--out") == 0) {
+            outPath = value;
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::mt19937 rng(seed);
+    std::unordered_map<uint64_t, int8_t> values;
+
+    for (int game = 0; game < numGames; game++) {
+        Connect4Position position;
+        int attempts = 0;
+        while (!playDown(position, maxEmpties, rng) && ++attempts < MAX_ATTEMPTS_PER_GAME) {
+            position.reset();
+        }
+        if (attempts == MAX_ATTEMPTS_PER_GAME) {
+            fprintf(stderr, "no game lasted until %d empty cells\n", maxEmpties);
+            return 1;
+        }
+        solve(position, values);
+        if ((game + 1) % 10 == 0) {
+            fprintf(stderr, "%d/%d games, %zu positions\n", game + 1, numGames, values.size());
+        }
+    }
+
+    std::vector<Connect4EndgameDB::Entry> entries;
+    entries.reserve(values.size());
+    for (const auto &value : values) {
+        entries.push_back({value.first, (Connect4EndgameDB::Value)value.second});
+    }
+    if (!Connect4EndgameDB::write(outPath, maxEmpties, entries)) {
+        fprintf(stderr, "couldn't write %s\n", outPath.c_str());
+        return 1;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("wrote %zu positions to %s in %.1fs\n", entries.size(), outPath.c_str(), elapsed);
+    return 0;
+}
@@ -0,0 +1,431 @@
+//
+// gamecheck: headless checks of the game layer, the code between the engines and the window
+// builds the real games with sprites that load no textures, runs each check and exits
+// non-zero if any of them fails
+//
+// usage: gamecheck, from the repository root so the games find their textures
+//
+// switch-mid-search   deleting a game while its AI is searching returns at once and gives
+//                     back every byte the game allocated, engine tables included
+// tictactoe-search    Search<> over TicTacToeSearchState at full depth agrees with the
+//                     solved table on every reachable position
+// connect4-search     Search<> over Connect4SearchState at full depth agrees with the
+//                     exact solver on random late positions
+// record-round-trip   a fresh game records no start state, and a random game of each
+//                     kind, recorded, saved, loaded and replayed, gives back the same
+//                     state at every turn
+//
+#include "../classes/Game.h"
+#include "../classes/Connect4.h"
+#include "../classes/Othello.h"
+#include "../classes/Checkers.h"
+#include "../classes/TicTacToe.h"
+#include "../classes/Connect4Solver.h"
+#include "../classes/TicTacToeSolver.h"
+#include "../Application.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
+#include <random>
+#include <thread>
+#include <vector>
+
+// turns end without an application to tell
+namespace ClassGame {
+    void EndOfTurn() {}
+}
+
+//
+// every allocation is counted so a check can tell whether a game gave back all it took
+// the size sits just in front of the block, together with where the block really starts
+//
+static std::atomic<int64_t> liveBytes(0);
+
+static void *trackedNew(std::size_t size, std::size_t align)
+{
+    std::size_t header = std::max<std::size_t>(align, 16);
+    unsigned char *base = static_cast<unsigned char *>(std::malloc(size + 2 * header));
+    if (!base) throw std::bad_alloc();
+    uintptr_t block = ((uintptr_t)base + 2 * header - 1) & ~(uintptr_t)(header - 1);
+    reinterpret_cast<void **>(block)[-1] = base;
+    reinterpret_cast<std::size_t *>(block)[-2] = size;
+    liveBytes += (int64_t)size;
+    return reinterpret_cast<void *>(block);
+}
+
+static void trackedDelete(void *block)
+{
+    if (!block) return;
+    liveBytes -= (int64_t)static_cast<std::size_t *>(block)[-2];
+    std::free(static_cast<void **>(block)[-1]);
+}
+
+void *operator new(std::size_t size) { return trackedNew(size, 0); }
+void *operator new[](std::size_t size) { return trackedNew(size, 0); }
+void *operator new(std::size_t size, std::align_val_t align) { return trackedNew(size, (std::size_t)align); }
+void *operator new[](std::size_t size, std::align_val_t align) { return trackedNew(size, (std::size_t)align); }
+void operator delete(void *block) noexcept { trackedDelete(block); }
+void operator delete[](void *block) noexcept { trackedDelete(block); }
+void operator delete(void *block, std::size_t) noexcept { trackedDelete(block); }
+void operator delete[](void *block, std::size_t) noexcept { trackedDelete(block); }
+void operator delete(void *block, std::align_val_t) noexcept { trackedDelete(block); }
+void operator delete[](void *block, std::align_val_t) noexcept { trackedDelete(block); }
+void operator delete(void *block, std::size_t, std::align_val_t) noexcept { trackedDelete(block); }
+void operator delete[](void *block, std::size_t, std::align_val_t) noexcept { trackedDelete(block); }
+
+static bool check(bool ok, const char *what)
+{
+    if (!ok) printf("    failed: %s\n", what);
+    return ok;
+}
+
+// longest a game may take to go away with its AI in the middle of a search
+static const int MAX_DELETE_MS = 250;
+// a check still running after this is stuck, most likely waiting on a search nobody stopped
+static const int WATCHDOG_SECONDS = 60;
+
+//
+// start an unlimited search, give it time to get going, then delete the game as
+// Application does when another game is picked; the first round of each game also
+// sets up whatever the games share for good (the opening book, the texture cache),
+// the second has to hand back everything
+//
+template <typename G>
+static bool switchMidSearch(const char *name, const std::vector<int> &opening)
+{
+    bool ok = true;
+    for (int round = 0; round < 2; round++) {
+        int64_t before = liveBytes;
+
+        Game *game = new G();
+        game->setUpBoard();
+        {
+            GameRecord record;
+            record.reset("");
+            for (int move : opening) record.append(move);
+            ok &= check(game->replay(record), "opening replays");
+        }
+
+        game->_gameOptions.AIMAXDepth = 64;
+        game->_gameOptions.AITimeBudgetMs = 0;
+        game->_gameOptions.AITableSizeMB = 64;
+        game->_gameOptions.AIThreads = 2;
+        game->getPlayerAt(0)->setAIPlayer(true);
+        game->getPlayerAt(1)->setAIPlayer(true);
+        game->updateAI();
+        ok &= check(game->isAIThinking(), "search starts");
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+        auto start = std::chrono::steady_clock::now();
+        delete game;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        int64_t leaked = liveBytes - before;
+        printf("    %s round %d: deleted in %.1f ms, %lld bytes still held\n", name, round + 1, ms, (long long)leaked);
+        ok &= check(ms < MAX_DELETE_MS, "delete doesn't wait for the search");
+        if (round == 1) ok &= check(leaked == 0, "every byte is given back");
+    }
+    return ok;
+}
+
+static bool checkSwitchMidSearch()
+{
+    bool ok = true;
+    // a connect 4 position past the opening book, so the AI has to search
+    ok &= switchMidSearch<Connect4>("connect4", {3, 4, 6, 3, 2, 5, 5, 5, 0, 6, 6, 1, 3, 6, 4, 3});
+    ok &= switchMidSearch<Othello>("othello", {});
+    ok &= switchMidSearch<Checkers>("checkers", {});
+    return ok;
+}
+
+// a score from Search<> as a result, 1 a win, 0 a draw, -1 a loss
+static int resultOf(int score)
+{
+    return (score > 0) - (score < 0);
+}
+
+//
+// every position the solved table can reach, searched to the end of the game: the score
+// has to give the table's result, and the move chosen has to keep it
+//
+static void searchEveryPosition(Search<TicTacToeSearchState> &search, TicTacToeSearchState &state,
+                                std::vector<bool> &seen, int &positions, int &wrong)
+{
+    if (seen[state.board.index()] || state.board.isGameOver()) return;
+    seen[state.board.index()] = true;
+    positions++;
+
+    static const int RESULTS[3] = {-1, 0, 1};   // indexed by TicTacToeSolver::Outcome
+    int expected = RESULTS[TicTacToeSolver::outcome(state.board)];
+
+    int score = 0;
+    int index = search.search(state, TicTacToeBoard::NUM_SQUARES, 0, score);
+    TicTacToeSearchState::Move moves[TicTacToeSearchState::MAX_MOVES];
+    int count = state.generateMoves(moves);
+    bool ok = index >= 0 && index < count && resultOf(score) == expected;
+    if (ok) {
+        // the reply's result is the opposite of ours if the move was a good one
+        TicTacToeBoard after = state.board;
+        after.play(moves[index]);
+        int reply = after.winner() >= 0 ? -1 : after.isFull() ? 0 : RESULTS[TicTacToeSolver::outcome(after)];
+        ok = (reply == -expected);
+    }
+    if (!ok) wrong++;
+
+    for (int i = 0; i < count; i++) {
+        state.makeMove(moves[i]);
+        searchEveryPosition(search, state, seen, positions, wrong);
+        state.unmakeMove(moves[i]);
+    }
+}
+
+static bool checkTicTacToeSearch()
+{
+    Search<TicTacToeSearchState> search;
+    search.setTableSize(1);
+    TicTacToeSearchState state;
+    std::vector<bool> seen(TicTacToeBoard::NUM_INDICES, false);
+    int positions = 0;
+    int wrong = 0;
+    searchEveryPosition(search, state, seen, positions, wrong);
+
+    printf("    %d positions searched, %d disagree with the table\n", positions, wrong);
+    return check(wrong == 0 && positions > 0, "full depth search matches the solved table");
+}
+
+// empty cells left in the random positions, small enough to search to the end
+static const int CONNECT4_CHECK_EMPTIES = 12;
+static const int CONNECT4_CHECK_POSITIONS = 40;
+
+static bool checkConnect4Search()
+{
+    Search<Connect4SearchState> search;
+    search.setTableSize(16);
+    Connect4Solver solver;
+    solver.setTableSize(16);
+    std::mt19937 rng(1);
+
+    int positions = 0;
+    int wrong = 0;
+    while (positions < CONNECT4_CHECK_POSITIONS) {
+        // random moves that never end the game, abandoned if one has to
+        Connect4SearchState state;
+        Connect4Position &position = state.position;
+        while (Connect4Position::NUM_CELLS - position.moves() > CONNECT4_CHECK_EMPTIES) {
+            int cols[Connect4Position::WIDTH];
+            int count = 0;
+            for (int col = 0; col < Connect4Position::WIDTH; col++) {
+                if (position.canPlay(col) && !position.isWinningMove(col)) cols[count++] = col;
+            }
+            if (count == 0) break;
+            position.play(cols[rng() % count]);
+        }
+        if (Connect4Position::NUM_CELLS - position.moves() != CONNECT4_CHECK_EMPTIES) continue;
+        positions++;
+
+        int score = 0;
+        search.search(state, CONNECT4_CHECK_EMPTIES, 0, score);
+        if (resultOf(score) != (int)solver.solve(position, 0)) wrong++;
+    }
+
+    printf("    %d positions with %d empty cells searched, %d disagree with the solver\n",
+           positions, CONNECT4_CHECK_EMPTIES, wrong);
+    return check(wrong == 0, "full depth search matches the solver");
+}
+
+//
+// a random game played on the core board, with the state after every move; the
+// move numbers are the ones the game records
+//
+struct RandomGame
+{
+    std::vector<int>            moves;
+    std::vector<std::string>    states;
+    // othello passes, which the game makes by itself and doesn't record
+    int                         passes = 0;
+};
+
+// checkers can go on forever once both sides have kings
+static const int MAX_RANDOM_MOVES = 200;
+
+static RandomGame randomConnect4(std::mt19937 &rng)
+{
+    RandomGame game;
+    Connect4Position position;
+    game.states.push_back(position.stateString());
+    while (!position.isFull() && !position.lastMoveWon()) {
+        int col;
+        do {
+            col = rng() % Connect4Position::WIDTH;
+        } while (!position.canPlay(col));
+        position.play(col);
+        game.moves.push_back(col);
+        game.states.push_back(position.stateString());
+    }
+    return game;
+}
+
+static RandomGame randomOthello(std::mt19937 &rng)
+{
+    RandomGame game;
+    OthelloBoard board;
+    game.states.push_back(board.stateString());
+    while (!board.isGameOver()) {
+        uint64_t legal = board.legalMoves();
+        if (!legal) {
+            board.pass();
+            game.passes++;
+            continue;
+        }
+        int pick = rng() % std::popcount(legal);
+        while (pick--) legal &= legal - 1;
+        int square = std::countr_zero(legal);
+        board.play(square);
+        game.moves.push_back(square);
+        game.states.push_back(board.stateString());
+    }
+    return game;
+}
+
+static RandomGame randomCheckers(std::mt19937 &rng)
+{
+    RandomGame game;
+    CheckersBoard board;
+    game.states.push_back(board.stateString());
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+    int count;
+    while ((int)game.moves.size() < MAX_RANDOM_MOVES && (count = board.generateMoves(moves)) > 0) {
+        int index = rng() % count;
+        board.makeMove(moves[index]);
+        game.moves.push_back(index);
+        game.states.push_back(board.stateString());
+    }
+    return game;
+}
+
+static RandomGame randomTicTacToe(std::mt19937 &rng)
+{
+    RandomGame game;
+    TicTacToeBoard board;
+    game.states.push_back(board.stateString());
+    while (!board.isGameOver()) {
+        int square;
+        do {
+            square = rng() % TicTacToeBoard::NUM_SQUARES;
+        } while (!board.canPlay(square));
+        board.play(square);
+        game.moves.push_back(square);
+        game.states.push_back(board.stateString());
+    }
+    return game;
+}
+
+//
+// record the game, replay it into a real game, save it on its own and again at the end
+// of the file as an archive, load both ways and step through the loaded record turn by turn
+//
+template <typename G>
+static bool recordRoundTrip(const RandomGame &played, int &wrong)
+{
+    bool ok = true;
+    GameRecord record;
+    record.reset("");
+    for (int move : played.moves) record.append(move);
+    ok &= check(record.moves() == played.moves, "the record gives back its moves");
+
+    Game *game = new G();
+    game->setUpBoard();
+    ok &= check(game->record().initialState().empty(), "a fresh game leaves its start out of the record");
+    ok &= check(game->replay(record), "the record replays");
+    ok &= check(game->record().moves() == played.moves, "the game records what it replayed");
+    ok &= check(game->stateString() == played.states.back(), "the replay ends where the game did");
+
+    std::string path = (std::filesystem::temp_directory_path() / "gamecheck.record").string();
+    ok &= check(record.save(path) && record.save(path, true), "the record saves");
+    GameRecord loaded;
+    ok &= check(loaded.load(path) && loaded.moves() == played.moves, "the record loads");
+    std::vector<GameRecord> archive;
+    ok &= check(GameRecord::loadAll(path, archive) && archive.size() == 2, "the archive loads");
+    for (const GameRecord &r : archive) {
+        ok &= check(r.moves() == played.moves && r.initialState() == record.initialState(), "archived records match");
+    }
+    std::filesystem::remove(path);
+    delete game;
+
+    game = new G();
+    game->setUpBoard();
+    ok &= check(game->replay(loaded), "the loaded record replays");
+    for (int turn = 0; turn <= (int)played.moves.size(); turn++) {
+        if (game->stateAtTurn(turn) != played.states[turn]) wrong++;
+    }
+    ok &= check(wrong == 0, "every turn comes back as it was played");
+    delete game;
+    return ok;
+}
+
+// enough games that othello passes at least once
+static const int RECORD_CHECK_GAMES = 20;
+
+template <typename G>
+static bool recordRoundTrips(const char *name, RandomGame (*play)(std::mt19937 &), std::mt19937 &rng)
+{
+    bool ok = true;
+    int moves = 0;
+    int passes = 0;
+    int wrong = 0;
+    for (int i = 0; i < RECORD_CHECK_GAMES; i++) {
+        RandomGame played = play(rng);
+        moves += (int)played.moves.size();
+        passes += played.passes;
+        ok &= recordRoundTrip<G>(played, wrong);
+    }
+    printf("    %s: %d games, %d moves, %d passes, %d turns differ\n", name, RECORD_CHECK_GAMES, moves, passes, wrong);
+    return ok;
+}
+
+static bool checkRecordRoundTrip()
+{
+    std::mt19937 rng(1);
+    bool ok = true;
+    ok &= recordRoundTrips<Connect4>("connect4", randomConnect4, rng);
+    ok &= recordRoundTrips<Othello>("othello", randomOthello, rng);
+    ok &= recordRoundTrips<Checkers>("checkers", randomCheckers, rng);
+    ok &= recordRoundTrips<TicTacToe>("tictactoe", randomTicTacToe, rng);
+    return ok;
+}
+
+int main()
+{
+    struct Check {
+        const char *name;
+        bool (*run)();
+    };
+    static const Check CHECKS[] = {
+        {"switch-mid-search", checkSwitchMidSearch},
+        {"tictactoe-search", checkTicTacToeSearch},
+        {"connect4-search", checkConnect4Search},
+        {"record-round-trip", checkRecordRoundTrip},
+    };
+
+    std::thread([]() {
+        std::this_thread::sleep_for(std::chrono::seconds(WATCHDOG_SECONDS));
+        printf("  FAILED: stuck for %d seconds\n", WATCHDOG_SECONDS);
+        fflush(stdout);
+        std::_Exit(1);
+    }).detach();
+
+    int failed = 0;
+    for (const Check &c : CHECKS) {
+        printf("%s\n", c.name);
+        bool ok = c.run();
+        printf("  %s\n", ok ? "ok" : "FAILED");
+        if (!ok) failed++;
+    }
+    return failed ? 1 : 0;
+}
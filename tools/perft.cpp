@@ -0,0 +1,279 @@
+//
+// perft: counts the positions move generation reaches at each depth
+// the counts are fixed by the rules alone, so after any change to move generation they
+// have to come out the same, and the time taken is a pure move generation speed
+//
+// usage: perft [--game connect4|othello|checkers|tictactoe] [--depth N] [--state STRING]
+//              [--player N] [--threads N] [--divide]
+//
+// --state starts from a game's state string instead of its initial position; othello and
+// checkers strings don't say who is to move, --player does (0 moves first, the default)
+// --divide also prints the count under each move from the root
+//
+// a finished game is a leaf, and a player with no move in othello passes, which counts
+// as a move; root moves are shared out between the threads
+//
+#include "../classes/Connect4Position.h"
+#include "../classes/OthelloBoard.h"
+#include "../classes/CheckersBoard.h"
+#include "../classes/TicTacToeBoard.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// what perft needs from each game: moves from a position, and making and taking them back
+// generate returns 0 once the game is over
+//
+struct Connect4Perft
+{
+    typedef Connect4Position Board;
+    typedef int Move;
+    static const int MAX_MOVES = Connect4Position::WIDTH;
+
+    static bool setState(Board &board, const std::string &s, int player) { return board.setStateString(s); }
+    static int generate(const Board &board, Move *moves)
+    {
+        if (board.isFull() || Connect4Position::hasFourInARow(board.board(0)) || Connect4Position::hasFourInARow(board.board(1))) {
+            return 0;
+        }
+        int count = 0;
+        for (int col = 0; col < Connect4Position::WIDTH; col++) {
+            if (board.canPlay(col)) moves[count++] = col;
+        }
+        return count;
+    }
+    static void play(Board &board, Move &col) { board.play(col); }
+    static void undo(Board &board, const Move &col) { board.undo(col); }
+    static std::string name(const Move &col) { return std::to_string(col); }
+};
+
+struct OthelloPerft
+{
+    typedef OthelloBoard Board;
+    struct Move {
+        int square;     // PASS when the player has nothing to play
+        uint64_t flips;
+    };
+    static const int PASS = -1;
+    static const int MAX_MOVES = OthelloBoard::NUM_SQUARES;
+
+    static bool setState(Board &board, const std::string &s, int player)
+    {
+        if (!board.setStateString(s)) return false;
+        board.setCurrentPlayer(player);
+        return true;
+    }
+    static int generate(const Board &board, Move *moves)
+    {
+        uint64_t legal = board.legalMoves();
+        if (!legal) {
+            if (!board.legalMovesFor(board.currentPlayer() ^ 1)) return 0;
+            moves[0] = {PASS, 0};
+            return 1;
+        }
+        int count = 0;
+        for (; legal; legal &= legal - 1) {
+            moves[count++] = {std::countr_zero(legal), 0};
+        }
+        return count;
+    }
+    static void play(Board &board, Move &move)
+    {
+        if (move.square == PASS) board.pass();
+        else move.flips = board.play(move.square);
+    }
+    static void undo(Board &board, const Move &move)
+    {
+        if (move.square == PASS) board.pass();
+        else board.undo(move.square, move.flips);
+    }
+    static std::string name(const Move &move)
+    {
+        if (move.square == PASS) return "pass";
+        return std::string(1, (char)('a' + move.square % OthelloBoard::SIZE)) + (char)('1' + move.square / OthelloBoard::SIZE);
+    }
+};
+
+struct CheckersPerft
+{
+    typedef CheckersBoard Board;
+    typedef CheckersMove Move;
+    static const int MAX_MOVES = CheckersBoard::MAX_MOVES;
+
+    static bool setState(Board &board, const std::string &s, int player)
+    {
+        if (!board.setStateString(s)) return false;
+        board.setCurrentPlayer(player);
+        return true;
+    }
+    static int generate(const Board &board, Move *moves) { return board.generateMoves(moves); }
+    static void play(Board &board, Move &move) { board.makeMove(move); }
+    static void undo(Board &board, const Move &move) { board.unmakeMove(move); }
+    static std::string name(const Move &move)
+    {
+        // appended piece by piece, string + chains trip -Wrestrict in gcc
+        std::string text = std::to_string(move.from);
+        if (move.numJumps == 0) {
+            text.append("-").append(std::to_string(move.to));
+            return text;
+        }
+        for (int i = 0; i < move.numJumps; i++) {
+            text.append("x").append(std::to_string(move.path[i]));
+        }
+        return text;
+    }
+};
+
+struct TicTacToePerft
+{
+    typedef TicTacToeBoard Board;
+    typedef int Move;
+    static const int MAX_MOVES = TicTacToeBoard::NUM_SQUARES;
+
+    static bool setState(Board &board, const std::string &s, int player) { return board.setStateString(s); }
+    static int generate(const Board &board, Move *moves)
+    {
+        if (board.isGameOver()) return 0;
+        int count = 0;
+        for (int square = 0; square < TicTacToeBoard::NUM_SQUARES; square++) {
+            if (board.canPlay(square)) moves[count++] = square;
+        }
+        return count;
+    }
+    static void play(Board &board, Move &square) { board.play(square); }
+    static void undo(Board &board, const Move &square) { board.undo(square); }
+    static std::string name(const Move &square) { return std::to_string(square); }
+};
+
+template <typename Game>
+static uint64_t perft(typename Game::Board &board, int depth)
+{
+    if (depth == 0) return 1;
+
+    typename Game::Move moves[Game::MAX_MOVES];
+    int count = Game::generate(board, moves);
+    if (depth == 1) return (uint64_t)count;
+
+    uint64_t nodes = 0;
+    for (int i = 0; i < count; i++) {
+        Game::play(board, moves[i]);
+        nodes += perft<Game>(board, depth - 1);
+        Game::undo(board, moves[i]);
+    }
+    return nodes;
+}
+
+//
+// every depth from 1 up, each root move searched by whichever thread is free next
+//
+template <typename Game>
+static int run(const std::string &state, int player, int maxDepth, int numThreads, bool divide)
+{
+    // a new board is the game's initial position
+    typename Game::Board root;
+    if (!state.empty() && !Game::setState(root, state, player)) {
+        fprintf(stderr, "not a state string for this game: %s\n", state.c_str());
+        return 1;
+    }
+
+    typename Game::Move rootMoves[Game::MAX_MOVES];
+    int numRootMoves = Game::generate(root, rootMoves);
+
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        std::vector<uint64_t> counts(numRootMoves, 0);
+        std::atomic<int> next(0);
+        auto start = std::chrono::steady_clock::now();
+
+        auto worker = [&]() {
+            typename Game::Board board = root;
+            for (int i = next++; i < numRootMoves; i = next++) {
+                typename Game::Move move = rootMoves[i];
+                Game::play(board, move);
+                counts[i] = perft<Game>(board, depth - 1);
+                Game::undo(board, move);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (int i = 0; i < std::min(numThreads, std::max(1, numRootMoves)); i++) {
+            threads.emplace_back(worker);
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        uint64_t nodes = 0;
+        for (uint64_t count : counts) nodes += count;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printf("depth %2d  %16llu nodes  %8.3fs  %14.0f nodes/s\n", depth, (unsigned long long)nodes, seconds,
+               seconds > 0.0 ? nodes / seconds : 0.0);
+        if (divide && depth == maxDepth) {
+            for (int i = 0; i < numRootMoves; i++) {
+                printf("  %-12s %llu\n", Game::name(rootMoves[i]).c_str(), (unsigned long long)counts[i]);
+            }
+        }
+    }
+    return 0;
+}
+
+static void printUsage()
+{
+    printf("usage: perft [--game connect4|othello|checkers|tictactoe] [--depth N] [--state STRING]\n");
+    printf("             [--player N] [--threads N] [--divide]\n");
+}
+
+int main(int argc, char **argv)
+{
+    std::string game = "connect4";
+    std::string state;
+    int depth = 6;
+    int player = 0;
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    bool divide = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0) {
+            printUsage();
+            return 0;
+        }
+        if (strcmp(arg, "--divide") == 0) {
+            divide = true;
+            continue;
+        }
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (!value) {
+            printUsage();
+            return 1;
+        }
+        i++;
+        if (strcmp(arg, "--game") == 0) {
+            game = value;
+        } else if (strcmp(arg, "--depth") == 0) {
+            depth = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--state") == 0) {
+            state = value;
+        } else if (strcmp(arg, "--player") == 0) {
+            player = atoi(value) & 1;
+        } else if (strcmp(arg, "--threads") == 0) {
+            numThreads = std::max(1, atoi(value));
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (game == "connect4") return run<Connect4Perft>(state, player, depth, numThreads, divide);
+    if (game == "othello") return run<OthelloPerft>(state, player, depth, numThreads, divide);
+    if (game == "checkers") return run<CheckersPerft>(state, player, depth, numThreads, divide);
+    if (game == "tictactoe") return run<TicTacToePerft>(state, player, depth, numThreads, divide);
+    printUsage();
+    return 1;
+}
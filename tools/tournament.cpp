@@ -0,0 +1,378 @@
+//
+// headless AI vs AI tournament runner
+// plays many games between two engine settings on all cores, without a window or textures,
+// and reports the results, an Elo difference and how fast each side searched
+//
+// usage: tournament [--game connect4|othello|checkers] [--games N] [--threads N] [--random-plies N] [--seed N]
+//                   [--a depth=N,time=MS,tt=MB] [--b depth=N,time=MS,tt=MB] [--endgame FILE] [--stats FILE]
+//
+// --endgame gives both connect 4 engines a table written by connect4endgame
+// --stats writes every search's depth, nodes, cutoffs, table use and PV to a file, one JSON line each
+//
+// games are played in pairs from the same random opening with the colors swapped
+// checkers games that go on past MAX_CHECKERS_PLIES are scored as draws
+//
+#include "../classes/Connect4Position.h"
+#include "../classes/Connect4AI.h"
+#include "../classes/Connect4EndgameDB.h"
+#include "../classes/OthelloBoard.h"
+#include "../classes/OthelloAI.h"
+#include "../classes/CheckersBoard.h"
+#include "../classes/CheckersAI.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct EngineSettings
+{
+    int maxDepth = 64;
+    int timeMs = 50;
+    int tableMB = 16;
+};
+
+// per-side totals, merged across worker threads
+struct EngineStats
+{
+    uint64_t nodes = 0;
+    double searchSeconds = 0.0;
+    uint64_t moves = 0;
+    // every search of the game, only kept for --stats
+    bool keepSearches = false;
+    std::vector<SearchStats> searches;
+};
+
+struct TournamentResults
+{
+    int wins = 0;       // from engine A's point of view
+    int draws = 0;
+    int losses = 0;
+    EngineStats engines[2];
+};
+
+enum GameType {
+    GAME_CONNECT4,
+    GAME_OTHELLO,
+    GAME_CHECKERS
+};
+
+static const int MAX_CHECKERS_PLIES = 200;
+
+static bool parseEngine(const char *text, EngineSettings &settings)
+{
+    std::string spec = text;
+    size_t start = 0;
+    while (start < spec.length()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) end = spec.length();
+        std::string item = spec.substr(start, end - start);
+        size_t eq = item.find('=');
+        if (eq == std::string::npos) return false;
+
+        std::string key = item.substr(0, eq);
+        int value = atoi(item.c_str() + eq + 1);
+        if (key == "depth") settings.maxDepth = value;
+        else if (key == "time") settings.timeMs = value;
+        else if (key == "tt") settings.tableMB = value;
+        else return false;
+        start = end + 1;
+    }
+    return true;
+}
+
+//
+// one game of connect 4, returns 0 or 1 for the winning engine or -1 for a draw
+//
+static int playConnect4(Connect4AI *engines[2], const EngineSettings settings[2], int firstEngine,
+                        int randomPlies, std::mt19937 &rng, EngineStats stats[2])
+{
+    Connect4Position position;
+
+    // random opening, never allowed to end the game
+    for (int ply = 0; ply < randomPlies; ply++) {
+        int cols[Connect4Position::WIDTH];
+        int count = 0;
+        for (int col = 0; col < Connect4Position::WIDTH; col++) {
+            if (position.canPlay(col) && !position.isWinningMove(col)) cols[count++] = col;
+        }
+        if (count == 0) break;
+        position.play(cols[rng() % count]);
+    }
+
+    while (!position.isFull()) {
+        int side = (position.currentPlayer() + firstEngine) & 1;
+
+        auto start = std::chrono::steady_clock::now();
+        int score = 0;
+        int col = engines[side]->search(position, settings[side].maxDepth, settings[side].timeMs, score);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        stats[side].nodes += engines[side]->nodes();
+        stats[side].searchSeconds += seconds;
+        stats[side].moves++;
+        if (stats[side].keepSearches) stats[side].searches.push_back(engines[side]->stats());
+
+        if (col < 0) break;
+        if (position.isWinningMove(col)) return side;
+        position.play(col);
+    }
+    return -1;
+}
+
+//
+// one game of othello, returns 0 or 1 for the winning engine or -1 for a draw
+//
+static int playOthello(OthelloAI *engines[2], const EngineSettings settings[2], int firstEngine,
+                       int randomPlies, std::mt19937 &rng, EngineStats stats[2])
+{
+    OthelloBoard board;
+
+    for (int ply = 0; ply < randomPlies && !board.isGameOver(); ply++) {
+        uint64_t moves = board.legalMoves();
+        if (!moves) {
+            board.pass();
+            continue;
+        }
+        int pick = rng() % std::popcount(moves);
+        while (pick--) moves &= moves - 1;
+        board.play(std::countr_zero(moves));
+    }
+
+    while (!board.isGameOver()) {
+        if (!board.legalMoves()) {
+            board.pass();
+            continue;
+        }
+        int side = (board.currentPlayer() + firstEngine) & 1;
+
+        auto start = std::chrono::steady_clock::now();
+        int score = 0;
+        int square = engines[side]->search(board, settings[side].maxDepth, settings[side].timeMs, score);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        stats[side].nodes += engines[side]->nodes();
+        stats[side].searchSeconds += seconds;
+        stats[side].moves++;
+        if (stats[side].keepSearches) stats[side].searches.push_back(engines[side]->stats());
+
+        if (square < 0) break;
+        board.play(square);
+    }
+
+    // colors are engine order shifted by firstEngine
+    int black = board.count(0);
+    int white = board.count(1);
+    if (black == white) return -1;
+    int winningColor = (black > white) ? 0 : 1;
+    return (winningColor + firstEngine) & 1;
+}
+
+//
+// one game of checkers, returns 0 or 1 for the winning engine or -1 for a draw
+//
+static int playCheckers(CheckersAI *engines[2], const EngineSettings settings[2], int firstEngine,
+                        int randomPlies, std::mt19937 &rng, EngineStats stats[2])
+{
+    CheckersBoard board;
+    CheckersMove moves[CheckersBoard::MAX_MOVES];
+
+    for (int ply = 0; ply < randomPlies; ply++) {
+        int count = board.generateMoves(moves);
+        if (count == 0) break;
+        board.makeMove(moves[rng() % count]);
+    }
+
+    for (int ply = 0; ply < MAX_CHECKERS_PLIES; ply++) {
+        int side = (board.currentPlayer() + firstEngine) & 1;
+        int count = board.generateMoves(moves);
+        if (count == 0) return side ^ 1;
+
+        auto start = std::chrono::steady_clock::now();
+        int score = 0;
+        int move = engines[side]->search(board, settings[side].maxDepth, settings[side].timeMs, score);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        stats[side].nodes += engines[side]->nodes();
+        stats[side].searchSeconds += seconds;
+        stats[side].moves++;
+        if (stats[side].keepSearches) stats[side].searches.push_back(engines[side]->stats());
+
+        if (move < 0 || move >= count) break;
+        board.makeMove(moves[move]);
+    }
+    return -1;
+}
+
+static double eloFromScore(double score)
+{
+    score = std::min(std::max(score, 0.001), 0.999);
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+static void printUsage()
+{
+    printf("usage: tournament [--game connect4|othello|checkers] [--games N] [--threads N] [--random-plies N] [--seed N]\n");
+    printf("                  [--a depth=N,time=MS,tt=MB] [--b depth=N,time=MS,tt=MB] [--endgame FILE] [--stats FILE]\n");
+}
+
+int main(int argc, char **argv)
+{
+    GameType gameType = GAME_CONNECT4;
+    int numGames = 100;
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    int randomPlies = 4;
+    unsigned int seed = 1;
+    EngineSettings settings[2];
+    Connect4EndgameDB endgame;
+    std::ofstream statsFile;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--help") == 0) {
+            printUsage();
+            return 0;
+        }
+        if (!value) {
+            printUsage();
+            return 1;
+        }
+        i++;
+        if (strcmp(arg, "--game") == 0) {
+            if (strcmp(value, "connect4") == 0) gameType = GAME_CONNECT4;
+            else if (strcmp(value, "othello") == 0) gameType = GAME_OTHELLO;
+            else if (strcmp(value, "checkers") == 0) gameType = GAME_CHECKERS;
+            else { printUsage(); return 1; }
+        } else if (strcmp(arg, "--games") == 0) {
+            numGames = std::max(2, atoi(value));
+        } else if (strcmp(arg, "--threads") == 0) {
+            numThreads = std::max(1, atoi(value));
+        } else if (strcmp(arg, "--random-plies") == 0) {
+            randomPlies = std::max(0, atoi(value));
+        } else if (strcmp(arg, "--seed") == 0) {
+            seed = (unsigned int)strtoul(value, nullptr, 10);
+        } else if (strcmp(arg, "--endgame") == 0) {
+            if (!endgame.open(value)) {
+                fprintf(stderr, "couldn't open endgame table %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--stats") == 0) {
+            statsFile.open(value);
+            if (!statsFile) {
+                fprintf(stderr, "couldn't write %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "--a") == 0 || strcmp(arg, "--b") == 0) {
+            if (!parseEngine(value, settings[arg[2] == 'a' ? 0 : 1])) { printUsage(); return 1; }
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    // play whole pairs so every opening is seen from both sides
+    int numPairs = (numGames + 1) / 2;
+    numGames = numPairs * 2;
+
+    TournamentResults results;
+    std::mutex resultsMutex;
+    std::atomic<int> nextPair(0);
+    std::atomic<int> gamesDone(0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    auto worker = [&]() {
+        // every worker owns its engines and tables, one search thread each
+        Connect4AI connect4[2];
+        OthelloAI othello[2];
+        CheckersAI checkers[2];
+        for (int side = 0; side < 2; side++) {
+            connect4[side].setThreads(1);
+            connect4[side].setEndgameDB(endgame.isOpen() ? &endgame : nullptr);
+            if (gameType == GAME_CONNECT4) connect4[side].setTableSize(settings[side].tableMB);
+            else if (gameType == GAME_OTHELLO) othello[side].setTableSize(settings[side].tableMB);
+            else checkers[side].setTableSize(settings[side].tableMB);
+        }
+        Connect4AI *connect4Engines[2] = {&connect4[0], &connect4[1]};
+        OthelloAI *othelloEngines[2] = {&othello[0], &othello[1]};
+        CheckersAI *checkersEngines[2] = {&checkers[0], &checkers[1]};
+
+        for (int pair = nextPair++; pair < numPairs; pair = nextPair++) {
+            for (int firstEngine = 0; firstEngine < 2; firstEngine++) {
+                std::mt19937 rng(seed * 7919u + (unsigned int)pair);
+                EngineStats stats[2];
+                stats[0].keepSearches = stats[1].keepSearches = statsFile.is_open();
+                int winner = -1;
+                if (gameType == GAME_CONNECT4) {
+                    winner = playConnect4(connect4Engines, settings, firstEngine, randomPlies, rng, stats);
+                } else if (gameType == GAME_OTHELLO) {
+                    winner = playOthello(othelloEngines, settings, firstEngine, randomPlies, rng, stats);
+                } else {
+                    winner = playCheckers(checkersEngines, settings, firstEngine, randomPlies, rng, stats);
+                }
+
+                std::lock_guard<std::mutex> lock(resultsMutex);
+                if (winner == 0) results.wins++;
+                else if (winner == 1) results.losses++;
+                else results.draws++;
+                for (int side = 0; side < 2; side++) {
+                    for (const SearchStats &search : stats[side].searches) {
+                        statsFile << "{\"game\": " << pair * 2 + firstEngine << ", \"engine\": \"" << (side == 0 ? 'A' : 'B')
+                                  << "\", \"search\": " << search.toJson() << "}\n";
+                    }
+                    results.engines[side].nodes += stats[side].nodes;
+                    results.engines[side].searchSeconds += stats[side].searchSeconds;
+                    results.engines[side].moves += stats[side].moves;
+                }
+                int done = ++gamesDone;
+                if (done % 50 == 0) {
+                    fprintf(stderr, "%d/%d games\n", done, numGames);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++) {
+        threads.emplace_back(worker);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // score and Elo from A's point of view, with a 95% interval from the per-game variance
+    double n = (double)numGames;
+    double score = (results.wins + 0.5 * results.draws) / n;
+    double variance = (results.wins * std::pow(1.0 - score, 2) +
+                       results.draws * std::pow(0.5 - score, 2) +
+                       results.losses * std::pow(0.0 - score, 2)) / n;
+    double margin = 1.96 * std::sqrt(variance / n);
+    double elo = eloFromScore(score);
+    double eloMargin = (eloFromScore(score + margin) - eloFromScore(score - margin)) / 2.0;
+
+    static const char *GAME_NAMES[] = {"Connect 4", "Othello", "Checkers"};
+    printf("%s: %d games on %d threads in %.1fs\n", GAME_NAMES[gameType], numGames, numThreads, elapsed);
+    for (int side = 0; side < 2; side++) {
+        const EngineStats &stats = results.engines[side];
+        double nps = stats.searchSeconds > 0.0 ? stats.nodes / stats.searchSeconds : 0.0;
+        double latency = stats.moves ? 1000.0 * stats.searchSeconds / stats.moves : 0.0;
+        printf("  %c: depth %d, %d ms, %d MB | %.0f nodes/s, %.2f ms/move over %llu moves\n",
+               side == 0 ? 'A' : 'B', settings[side].maxDepth, settings[side].timeMs, settings[side].tableMB,
+               nps, latency, (unsigned long long)stats.moves);
+    }
+    printf("  A wins %d, draws %d, losses %d | score %.1f%% | Elo %+.1f +/- %.1f\n",
+           results.wins, results.draws, results.losses, 100.0 * score, elo, eloMargin);
+    return 0;
+}